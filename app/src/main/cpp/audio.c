@@ -0,0 +1,440 @@
+#define _POSIX_C_SOURCE 200809L
+#include "audio.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PLATFORM_ANDROID)
+#include <SLES/OpenSLES.h>
+#include <SLES/OpenSLES_Android.h>
+#else
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#define AUDIO_PI 3.14159265358979323846f
+
+#define JUMP_SAMPLES     (AUDIO_SAMPLE_RATE * 16 / 100) // 160 ms
+#define FOOTSTEP_SAMPLES (AUDIO_SAMPLE_RATE * 7 / 100)  // 70 ms
+
+/* =============================
+   SOUND BANK (preallocated)
+============================= */
+static float jumpSamples[JUMP_SAMPLES];
+static float footstepSamples[FOOTSTEP_SAMPLES];
+
+typedef struct SoundData {
+    const float *samples;
+    int length;
+} SoundData;
+
+static const SoundData soundBank[AUDIO_SOUND_COUNT] = {
+    [AUDIO_SOUND_JUMP]     = { jumpSamples, JUMP_SAMPLES },
+    [AUDIO_SOUND_FOOTSTEP] = { footstepSamples, FOOTSTEP_SAMPLES },
+};
+
+// Rising chirp with a fast attack and exponential tail
+static void SynthJump(float *out, int length)
+{
+    float phase = 0.0f;
+    for (int i = 0; i < length; i++)
+    {
+        float t = (float)i / length;
+        float freq = 320.0f * powf(760.0f / 320.0f, t);
+        phase += 2.0f * AUDIO_PI * freq / AUDIO_SAMPLE_RATE;
+
+        float env = fminf(1.0f, i / (0.005f * AUDIO_SAMPLE_RATE)) * expf(-4.0f * t);
+        out[i] = env * (0.8f * sinf(phase) + 0.2f * sinf(2.0f * phase));
+    }
+}
+
+// Low-passed noise burst over a short low thump
+static void SynthFootstep(float *out, int length)
+{
+    uint32_t seed = 0x1234567u;
+    float lowpass = 0.0f;
+    for (int i = 0; i < length; i++)
+    {
+        float t = (float)i / length;
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (float)(seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+        lowpass += 0.18f * (noise - lowpass);
+
+        float thump = sinf(2.0f * AUDIO_PI * 90.0f * i / AUDIO_SAMPLE_RATE);
+        out[i] = expf(-9.0f * t) * (0.7f * lowpass + 0.5f * thump);
+    }
+}
+
+/* =============================
+   COMMAND QUEUE (lock-free SPSC)
+============================= */
+typedef enum { AUDIO_CMD_PLAY = 0 } AudioCommandType;
+
+typedef struct AudioCommand {
+    int type;
+    int sound;
+    float volume;
+    float pitch;
+} AudioCommand;
+
+// head is written only by the game thread, tail only by the audio thread
+static AudioCommand queue[AUDIO_QUEUE_SIZE];
+static uint32_t queueHead;
+static uint32_t queueTail;
+
+static bool QueuePush(const AudioCommand *cmd)
+{
+    uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+    if (head - tail >= AUDIO_QUEUE_SIZE) return false;
+
+    queue[head & (AUDIO_QUEUE_SIZE - 1)] = *cmd;
+    __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool QueuePop(AudioCommand *cmd)
+{
+    uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+    if (tail == head) return false;
+
+    *cmd = queue[tail & (AUDIO_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* =============================
+   MIXER (audio thread only)
+============================= */
+typedef struct Voice {
+    const SoundData *sound;
+    float position;
+    float step;
+    float gain;
+    uint32_t age;
+} Voice;
+
+static Voice voices[AUDIO_MAX_VOICES];
+static uint32_t voiceClock;
+static float mixBuffer[AUDIO_FRAMES_PER_BUFFER];
+
+static AudioStats stats;
+static uint32_t droppedCommands; // Game thread side, copied into snapshots
+
+static void StartVoice(const AudioCommand *cmd)
+{
+    if (cmd->sound < 0 || cmd->sound >= AUDIO_SOUND_COUNT) return;
+
+    // Take a free voice, or steal the oldest one
+    Voice *target = &voices[0];
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++)
+    {
+        if (!voices[i].sound) { target = &voices[i]; break; }
+        if (voices[i].age < target->age) target = &voices[i];
+    }
+
+    target->sound = &soundBank[cmd->sound];
+    target->position = 0.0f;
+    target->step = (cmd->pitch > 0.0f) ? cmd->pitch : 1.0f;
+    target->gain = cmd->volume;
+    target->age = voiceClock++;
+}
+
+static uint64_t NowMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Called from the real-time thread: no allocation, no locks, bounded work
+static void MixBuffer(int16_t *out, int frames)
+{
+    uint64_t start = NowMicros();
+
+    AudioCommand cmd;
+    while (QueuePop(&cmd))
+    {
+        if (cmd.type == AUDIO_CMD_PLAY) StartVoice(&cmd);
+    }
+
+    memset(mixBuffer, 0, sizeof(float) * frames);
+
+    int active = 0;
+    for (int v = 0; v < AUDIO_MAX_VOICES; v++)
+    {
+        Voice *voice = &voices[v];
+        if (!voice->sound) continue;
+
+        const float *samples = voice->sound->samples;
+        int last = voice->sound->length - 1;
+        for (int i = 0; i < frames; i++)
+        {
+            int index = (int)voice->position;
+            if (index >= last)
+            {
+                voice->sound = NULL;
+                break;
+            }
+            float frac = voice->position - index;
+            mixBuffer[i] += voice->gain * (samples[index] + (samples[index + 1] - samples[index]) * frac);
+            voice->position += voice->step;
+        }
+        if (voice->sound) active++;
+    }
+
+    for (int i = 0; i < frames; i++)
+    {
+        float s = mixBuffer[i];
+        if (s > 1.0f) s = 1.0f;
+        else if (s < -1.0f) s = -1.0f;
+        out[i] = (int16_t)(s * 32767.0f);
+    }
+
+    uint32_t elapsed = (uint32_t)(NowMicros() - start);
+    uint32_t budget = (uint32_t)((uint64_t)frames * 1000000u / AUDIO_SAMPLE_RATE);
+
+    __atomic_store_n(&stats.lastMixMicros, elapsed, __ATOMIC_RELAXED);
+    if (elapsed > __atomic_load_n(&stats.maxMixMicros, __ATOMIC_RELAXED))
+        __atomic_store_n(&stats.maxMixMicros, elapsed, __ATOMIC_RELAXED);
+    if (elapsed > budget) __atomic_add_fetch(&stats.deadlineMisses, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.activeVoices, active, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats.framesMixed, (uint64_t)frames, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats.totalMixMicros, (uint64_t)elapsed, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats.callbacks, 1, __ATOMIC_RELAXED);
+}
+
+static int16_t outputBuffers[AUDIO_BUFFER_COUNT][AUDIO_FRAMES_PER_BUFFER];
+static int outputIndex;
+
+#if defined(PLATFORM_ANDROID)
+/* =============================
+   OPENSL ES BACKEND
+============================= */
+static SLObjectItf engineObject;
+static SLObjectItf outputMixObject;
+static SLObjectItf playerObject;
+static SLPlayItf playerPlay;
+static SLAndroidSimpleBufferQueueItf playerQueue;
+
+static void BufferQueueCallback(SLAndroidSimpleBufferQueueItf bq, void *context)
+{
+    int16_t *buffer = outputBuffers[outputIndex];
+    outputIndex = (outputIndex + 1) % AUDIO_BUFFER_COUNT;
+
+    MixBuffer(buffer, AUDIO_FRAMES_PER_BUFFER);
+    (*bq)->Enqueue(bq, buffer, sizeof(outputBuffers[0]));
+}
+
+static bool BackendStart(void)
+{
+    SLEngineItf engine;
+
+    if (slCreateEngine(&engineObject, 0, NULL, 0, NULL, NULL) != SL_RESULT_SUCCESS) return false;
+    if ((*engineObject)->Realize(engineObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS) return false;
+    if ((*engineObject)->GetInterface(engineObject, SL_IID_ENGINE, &engine) != SL_RESULT_SUCCESS) return false;
+
+    if ((*engine)->CreateOutputMix(engine, &outputMixObject, 0, NULL, NULL) != SL_RESULT_SUCCESS) return false;
+    if ((*outputMixObject)->Realize(outputMixObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS) return false;
+
+    SLDataLocator_AndroidSimpleBufferQueue queueLocator = {
+        SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, AUDIO_BUFFER_COUNT
+    };
+    SLDataFormat_PCM format = {
+        SL_DATAFORMAT_PCM, 1, AUDIO_SAMPLE_RATE * 1000, // OpenSL wants milliHertz
+        SL_PCMSAMPLEFORMAT_FIXED_16, SL_PCMSAMPLEFORMAT_FIXED_16,
+        SL_SPEAKER_FRONT_CENTER, SL_BYTEORDER_LITTLEENDIAN
+    };
+    SLDataSource source = { &queueLocator, &format };
+
+    SLDataLocator_OutputMix mixLocator = { SL_DATALOCATOR_OUTPUTMIX, outputMixObject };
+    SLDataSink sink = { &mixLocator, NULL };
+
+    const SLInterfaceID ids[1] = { SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
+    const SLboolean required[1] = { SL_BOOLEAN_TRUE };
+
+    if ((*engine)->CreateAudioPlayer(engine, &playerObject, &source, &sink, 1, ids, required) != SL_RESULT_SUCCESS) return false;
+    if ((*playerObject)->Realize(playerObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS) return false;
+    if ((*playerObject)->GetInterface(playerObject, SL_IID_PLAY, &playerPlay) != SL_RESULT_SUCCESS) return false;
+    if ((*playerObject)->GetInterface(playerObject, SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &playerQueue) != SL_RESULT_SUCCESS) return false;
+    if ((*playerQueue)->RegisterCallback(playerQueue, BufferQueueCallback, NULL) != SL_RESULT_SUCCESS) return false;
+
+    // Prime every buffer so the callback chain keeps itself fed
+    for (int i = 0; i < AUDIO_BUFFER_COUNT; i++) BufferQueueCallback(playerQueue, NULL);
+
+    return (*playerPlay)->SetPlayState(playerPlay, SL_PLAYSTATE_PLAYING) == SL_RESULT_SUCCESS;
+}
+
+static void BackendStop(void)
+{
+    if (playerObject) (*playerObject)->Destroy(playerObject);
+    if (outputMixObject) (*outputMixObject)->Destroy(outputMixObject);
+    if (engineObject) (*engineObject)->Destroy(engineObject);
+    playerObject = NULL;
+    outputMixObject = NULL;
+    engineObject = NULL;
+    playerPlay = NULL;
+    playerQueue = NULL;
+}
+
+static void BackendSetPaused(bool paused)
+{
+    if (playerPlay)
+        (*playerPlay)->SetPlayState(playerPlay, paused ? SL_PLAYSTATE_PAUSED : SL_PLAYSTATE_PLAYING);
+}
+
+#else
+/* =============================
+   NULL / WAV SINK BACKEND
+============================= */
+static pthread_t sinkThread;
+static bool sinkRunning;
+static bool sinkPaused;
+static FILE *sinkWav;
+static uint32_t sinkWavBytes;
+
+static void WriteWavHeader(FILE *file, uint32_t dataBytes)
+{
+    uint32_t byteRate = AUDIO_SAMPLE_RATE * 2;
+    uint32_t riffSize = 36 + dataBytes;
+    uint32_t fmtSize = 16;
+    uint16_t pcm = 1, channels = 1, blockAlign = 2, bits = 16;
+    uint32_t rate = AUDIO_SAMPLE_RATE;
+
+    fseek(file, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, file); fwrite(&riffSize, 4, 1, file);
+    fwrite("WAVEfmt ", 1, 8, file); fwrite(&fmtSize, 4, 1, file);
+    fwrite(&pcm, 2, 1, file); fwrite(&channels, 2, 1, file);
+    fwrite(&rate, 4, 1, file); fwrite(&byteRate, 4, 1, file);
+    fwrite(&blockAlign, 2, 1, file); fwrite(&bits, 2, 1, file);
+    fwrite("data", 1, 4, file); fwrite(&dataBytes, 4, 1, file);
+}
+
+// Paces itself like a device would: one buffer per buffer-duration deadline
+static void *SinkThread(void *arg)
+{
+    (void)arg;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    long period = (long)AUDIO_FRAMES_PER_BUFFER * 1000000000L / AUDIO_SAMPLE_RATE;
+
+    while (__atomic_load_n(&sinkRunning, __ATOMIC_ACQUIRE))
+    {
+        if (!__atomic_load_n(&sinkPaused, __ATOMIC_ACQUIRE))
+        {
+            int16_t *buffer = outputBuffers[outputIndex];
+            outputIndex = (outputIndex + 1) % AUDIO_BUFFER_COUNT;
+            MixBuffer(buffer, AUDIO_FRAMES_PER_BUFFER);
+
+            if (sinkWav)
+                sinkWavBytes += (uint32_t)fwrite(buffer, sizeof(int16_t), AUDIO_FRAMES_PER_BUFFER, sinkWav) * sizeof(int16_t);
+        }
+
+        deadline.tv_nsec += period;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+    return NULL;
+}
+
+static bool BackendStart(void)
+{
+    const char *wavPath = getenv("UMG_AUDIO_WAV");
+    if (wavPath)
+    {
+        sinkWav = fopen(wavPath, "wb");
+        if (sinkWav) WriteWavHeader(sinkWav, 0);
+    }
+
+    sinkRunning = true;
+    if (pthread_create(&sinkThread, NULL, SinkThread, NULL) != 0)
+    {
+        sinkRunning = false;
+        return false;
+    }
+    return true;
+}
+
+static void BackendStop(void)
+{
+    if (sinkRunning)
+    {
+        __atomic_store_n(&sinkRunning, false, __ATOMIC_RELEASE);
+        pthread_join(sinkThread, NULL);
+    }
+
+    if (sinkWav)
+    {
+        WriteWavHeader(sinkWav, sinkWavBytes);
+        fclose(sinkWav);
+        sinkWav = NULL;
+    }
+}
+
+static void BackendSetPaused(bool paused)
+{
+    __atomic_store_n(&sinkPaused, paused, __ATOMIC_RELEASE);
+}
+#endif
+
+/* =============================
+   PUBLIC API (game thread)
+============================= */
+static bool audioReady;
+
+bool Audio_Init(void)
+{
+    if (audioReady) return true;
+
+    SynthJump(jumpSamples, JUMP_SAMPLES);
+    SynthFootstep(footstepSamples, FOOTSTEP_SAMPLES);
+
+    memset(voices, 0, sizeof(voices));
+    memset(&stats, 0, sizeof(stats));
+    queueHead = queueTail = 0;
+    droppedCommands = 0;
+
+    audioReady = BackendStart();
+    if (!audioReady) BackendStop();
+    return audioReady;
+}
+
+void Audio_Shutdown(void)
+{
+    BackendStop();
+    audioReady = false;
+}
+
+bool Audio_Play(AudioSound sound, float volume, float pitch)
+{
+    if (!audioReady) return false;
+
+    AudioCommand cmd = { AUDIO_CMD_PLAY, (int)sound, volume, pitch };
+    if (QueuePush(&cmd)) return true;
+
+    droppedCommands++;
+    return false;
+}
+
+void Audio_SetPaused(bool paused)
+{
+    if (audioReady) BackendSetPaused(paused);
+}
+
+void Audio_GetStats(AudioStats *out)
+{
+    out->callbacks = __atomic_load_n(&stats.callbacks, __ATOMIC_RELAXED);
+    out->framesMixed = __atomic_load_n(&stats.framesMixed, __ATOMIC_RELAXED);
+    out->totalMixMicros = __atomic_load_n(&stats.totalMixMicros, __ATOMIC_RELAXED);
+    out->deadlineMisses = __atomic_load_n(&stats.deadlineMisses, __ATOMIC_RELAXED);
+    out->maxMixMicros = __atomic_load_n(&stats.maxMixMicros, __ATOMIC_RELAXED);
+    out->lastMixMicros = __atomic_load_n(&stats.lastMixMicros, __ATOMIC_RELAXED);
+    out->activeVoices = __atomic_load_n(&stats.activeVoices, __ATOMIC_RELAXED);
+    out->droppedCommands = droppedCommands;
+}
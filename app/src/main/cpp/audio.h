@@ -0,0 +1,45 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define AUDIO_SAMPLE_RATE        48000
+#define AUDIO_FRAMES_PER_BUFFER  240 // 5 ms per callback at 48 kHz
+#define AUDIO_BUFFER_COUNT       2
+#define AUDIO_MAX_VOICES         16
+#define AUDIO_QUEUE_SIZE         64  // Must be a power of two
+
+typedef enum AudioSound {
+    AUDIO_SOUND_JUMP = 0,
+    AUDIO_SOUND_FOOTSTEP,
+    AUDIO_SOUND_COUNT
+} AudioSound;
+
+// Counters published by the audio thread. Read them with Audio_GetStats().
+typedef struct AudioStats {
+    uint64_t callbacks;
+    uint64_t framesMixed;
+    uint64_t totalMixMicros;  // Time spent mixing, framesMixed / this gives throughput
+    uint32_t deadlineMisses;  // Callbacks whose mix took longer than one buffer
+    uint32_t droppedCommands; // Audio_Play calls rejected because the queue was full
+    uint32_t maxMixMicros;
+    uint32_t lastMixMicros;
+    int activeVoices;
+} AudioStats;
+
+// Synthesizes the sound bank and starts the output backend: OpenSL ES on
+// Android, otherwise a paced sink thread that discards the mix or, if the
+// UMG_AUDIO_WAV environment variable names a file, records it as a WAV.
+bool Audio_Init(void);
+void Audio_Shutdown(void);
+
+// Game thread only. Never blocks; returns false if the command queue is full.
+bool Audio_Play(AudioSound sound, float volume, float pitch);
+
+// Stops pulling buffers while the activity is in the background.
+void Audio_SetPaused(bool paused);
+
+void Audio_GetStats(AudioStats *stats);
+
+#endif
@@ -137,6 +137,7 @@ bool Chat_HandleTouch(ChatState *chat, Vector2 touch, int finger)
                     strcpy(chat->sentText, chat->text);
                     chat->sentLength = chat->length;
                     chat->bubbleTimer = 5.0f;
+                    chat->pendingSend = true;
                     
                     chat->text[0] = '\0';
                     chat->length = 0;
@@ -269,9 +270,14 @@ void Chat_DrawBubble(ChatState *chat, Vector2 playerPos, float cameraX)
 {
     if (chat->sentLength == 0 || chat->bubbleTimer <= 0.0f) return;
 
+    Chat_DrawBubbleText(chat->sentText, playerPos, cameraX);
+}
+
+void Chat_DrawBubbleText(const char *text, Vector2 playerPos, float cameraX)
+{
     int padding = 8;
     int fontSize = 18;
-    int textWidth = MeasureText(chat->sentText, fontSize);
+    int textWidth = MeasureText(text, fontSize);
 
     Rectangle bubble = {
             playerPos.x - cameraX - textWidth / 2 - padding,
@@ -283,7 +289,7 @@ void Chat_DrawBubble(ChatState *chat, Vector2 playerPos, float cameraX)
     DrawRectangleRounded(bubble, 0.4f, 8, Fade(RAYWHITE, 0.95f));
     DrawRectangleRoundedLinesEx(bubble, 0.4f, 8, 2.0f, BLACK);
 
-    DrawText(chat->sentText,
+    DrawText(text,
              (int)(bubble.x + padding),
              (int)(bubble.y + padding),
              fontSize,
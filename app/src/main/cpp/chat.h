@@ -3,8 +3,7 @@
 
 #include "raylib.h"
 #include <stdbool.h>
-
-#define CHAT_MAX_TEXT 128
+#include "chatlimits.h"
 
 // Define screen dimensions if not already defined
 #ifndef SCREEN_WIDTH
@@ -26,6 +25,7 @@ typedef struct ChatState {
     
     char sentText[CHAT_MAX_TEXT]; // Text to display in bubble
     int sentLength;
+    bool pendingSend; // sentText is new and not yet handed to the network
     
     int activeFinger;
     float bubbleTimer;
@@ -41,5 +41,6 @@ bool Chat_HandleTouch(ChatState *chat, Vector2 touch, int finger);
 void Chat_DrawUI(ChatState *chat);
 
 void Chat_DrawBubble(ChatState *chat, Vector2 playerPos, float cameraX);
+void Chat_DrawBubbleText(const char *text, Vector2 playerPos, float cameraX);
 
 #endif
@@ -0,0 +1,8 @@
+#ifndef CHATLIMITS_H
+#define CHATLIMITS_H
+
+// Shared by the chat UI and the save state, kept apart from chat.h so the
+// save state builds without raylib
+#define CHAT_MAX_TEXT 128
+
+#endif
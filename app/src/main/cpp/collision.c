@@ -0,0 +1,265 @@
+#include "collision.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COLLISION_EPSILON 0.01f
+
+static void CellRange(const CollisionWorld *world, float x, float y, float width, float height,
+                      int *c0, int *r0, int *c1, int *r1)
+{
+    *c0 = (int)floorf((x - world->originX) / world->cellSize);
+    *r0 = (int)floorf((y - world->originY) / world->cellSize);
+    *c1 = (int)floorf((x + width - world->originX) / world->cellSize);
+    *r1 = (int)floorf((y + height - world->originY) / world->cellSize);
+
+    if (*c0 < 0) *c0 = 0;
+    if (*r0 < 0) *r0 = 0;
+    if (*c1 >= world->cols) *c1 = world->cols - 1;
+    if (*r1 >= world->rows) *r1 = world->rows - 1;
+}
+
+bool Collision_Build(CollisionWorld *world, const CollisionBox *boxes, int count, float cellSize)
+{
+    memset(world, 0, sizeof(CollisionWorld));
+    if (count <= 0 || cellSize <= 0.0f) return count == 0;
+
+    float minX = boxes[0].x, minY = boxes[0].y;
+    float maxX = boxes[0].x + boxes[0].width, maxY = boxes[0].y + boxes[0].height;
+    for (int i = 1; i < count; i++)
+    {
+        minX = fminf(minX, boxes[i].x);
+        minY = fminf(minY, boxes[i].y);
+        maxX = fmaxf(maxX, boxes[i].x + boxes[i].width);
+        maxY = fmaxf(maxY, boxes[i].y + boxes[i].height);
+    }
+
+    world->originX = minX;
+    world->originY = minY;
+    world->cellSize = cellSize;
+    world->cols = (int)ceilf((maxX - minX) / cellSize) + 1;
+    world->rows = (int)ceilf((maxY - minY) / cellSize) + 1;
+
+    // Size everything up front so the world is a single allocation
+    int cells = world->cols * world->rows;
+    size_t items = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int c0, r0, c1, r1;
+        CellRange(world, boxes[i].x, boxes[i].y, boxes[i].width, boxes[i].height, &c0, &r0, &c1, &r1);
+        items += (size_t)(c1 - c0 + 1) * (size_t)(r1 - r0 + 1);
+    }
+
+    size_t boxBytes = sizeof(CollisionBox) * (size_t)count;
+    size_t startBytes = sizeof(uint32_t) * (size_t)(cells + 1);
+    unsigned char *storage = malloc(boxBytes + startBytes + sizeof(uint32_t) * items);
+    if (!storage)
+    {
+        memset(world, 0, sizeof(CollisionWorld));
+        return false;
+    }
+
+    CollisionBox *ownBoxes = (CollisionBox *)storage;
+    uint32_t *cellStart = (uint32_t *)(storage + boxBytes);
+    uint32_t *cellItems = (uint32_t *)(storage + boxBytes + startBytes);
+    memcpy(ownBoxes, boxes, boxBytes);
+    memset(cellStart, 0, startBytes);
+
+    // Count per cell, prefix-sum into start offsets, then fill
+    for (int i = 0; i < count; i++)
+    {
+        int c0, r0, c1, r1;
+        CellRange(world, boxes[i].x, boxes[i].y, boxes[i].width, boxes[i].height, &c0, &r0, &c1, &r1);
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) cellStart[r * world->cols + c + 1]++;
+    }
+    for (int c = 0; c < cells; c++) cellStart[c + 1] += cellStart[c];
+
+    uint32_t *cursor = malloc(sizeof(uint32_t) * (size_t)cells);
+    if (!cursor)
+    {
+        free(storage);
+        memset(world, 0, sizeof(CollisionWorld));
+        return false;
+    }
+    memcpy(cursor, cellStart, sizeof(uint32_t) * (size_t)cells);
+
+    for (int i = 0; i < count; i++)
+    {
+        int c0, r0, c1, r1;
+        CellRange(world, boxes[i].x, boxes[i].y, boxes[i].width, boxes[i].height, &c0, &r0, &c1, &r1);
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) cellItems[cursor[r * world->cols + c]++] = (uint32_t)i;
+    }
+    free(cursor);
+
+    world->boxes = ownBoxes;
+    world->boxCount = count;
+    world->cellStart = cellStart;
+    world->cellItems = cellItems;
+    world->itemCount = (int)items;
+    world->storage = storage;
+    return true;
+}
+
+void Collision_Free(CollisionWorld *world)
+{
+    free(world->storage);
+    memset(world, 0, sizeof(CollisionWorld));
+}
+
+int Collision_Query(const CollisionWorld *world, float x, float y, float width, float height,
+                    int *out, int maxOut)
+{
+    if (world->boxCount == 0) return 0;
+
+    int c0, r0, c1, r1;
+    CellRange(world, x, y, width, height, &c0, &r0, &c1, &r1);
+
+    int found = 0;
+    for (int r = r0; r <= r1; r++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            int cell = r * world->cols + c;
+            uint32_t end = world->cellStart[cell + 1];
+            if (end > (uint32_t)world->itemCount) end = (uint32_t)world->itemCount;
+            for (uint32_t k = world->cellStart[cell]; k < end; k++)
+            {
+                if (world->cellItems[k] >= (uint32_t)world->boxCount) continue;
+                int index = (int)world->cellItems[k];
+                const CollisionBox *b = &world->boxes[index];
+                if (b->x > x + width || b->x + b->width < x ||
+                    b->y > y + height || b->y + b->height < y) continue;
+
+                // Boxes spanning several cells are listed in each of them; only
+                // report one from the first of its cells inside the query range
+                if (c != c0 || r != r0)
+                {
+                    int bc0, br0, bc1, br1;
+                    CellRange(world, b->x, b->y, b->width, b->height, &bc0, &br0, &bc1, &br1);
+                    if ((bc0 > c0 ? bc0 : c0) != c || (br0 > r0 ? br0 : r0) != r) continue;
+                }
+
+                if (found < maxOut) out[found] = index;
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+// Floor height of a slope box under x, clamped to the box
+static float SlopeSurface(const CollisionBox *b, float x)
+{
+    float t = (x - b->x) / b->width;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return (b->flags & COLLISION_SLOPE_UP) ? b->y + b->height * (1.0f - t) : b->y + b->height * t;
+}
+
+void Collision_Move(const CollisionWorld *world, CollisionBox *body, float dx, float dy,
+                    bool snapDown, CollisionMove *result)
+{
+    memset(result, 0, sizeof(CollisionMove));
+
+    // One broadphase query covers both sweeps and the snap range
+    int stackCandidates[COLLISION_MAX_CANDIDATES];
+    int *candidates = stackCandidates;
+    float minX = body->x + fminf(dx, 0.0f);
+    float maxX = body->x + body->width + fmaxf(dx, 0.0f);
+    float minY = body->y + fminf(dy, 0.0f) - COLLISION_SNAP_DISTANCE;
+    float maxY = body->y + body->height + fmaxf(dy, 0.0f) + COLLISION_SNAP_DISTANCE;
+    int count = Collision_Query(world, minX, minY, maxX - minX, maxY - minY,
+                                candidates, COLLISION_MAX_CANDIDATES);
+
+    // A dense spot or a huge sweep: query again into a buffer that fits them all
+    // rather than tunnelling through whatever did not make the cut
+    if (count > COLLISION_MAX_CANDIDATES)
+    {
+        int *heapCandidates = malloc(sizeof(int) * (size_t)count);
+        if (heapCandidates)
+        {
+            candidates = heapCandidates;
+            count = Collision_Query(world, minX, minY, maxX - minX, maxY - minY, candidates, count);
+        }
+        else count = COLLISION_MAX_CANDIDATES;
+    }
+
+    // A grounded body steps up ledges this low instead of stopping at them
+    float stepHeight = snapDown ? COLLISION_SNAP_DISTANCE : COLLISION_EPSILON;
+
+    /* --- Horizontal: only solids block, slopes and platforms are walked through --- */
+    if (dx != 0.0f)
+    {
+        float left = body->x, right = body->x + body->width;
+        float top = body->y, bottom = body->y + body->height;
+
+        for (int i = 0; i < count; i++)
+        {
+            const CollisionBox *b = &world->boxes[candidates[i]];
+            if (!(b->flags & COLLISION_SOLID)) continue;
+            if (b->y >= bottom - stepHeight || b->y + b->height <= top + COLLISION_EPSILON) continue;
+
+            if (dx > 0.0f && b->x >= right - COLLISION_EPSILON && b->x - right < dx)
+            {
+                dx = fmaxf(b->x - right, 0.0f);
+                result->hitWall = true;
+            }
+            else if (dx < 0.0f && b->x + b->width <= left + COLLISION_EPSILON && b->x + b->width - left > dx)
+            {
+                dx = fminf(b->x + b->width - left, 0.0f);
+                result->hitWall = true;
+            }
+        }
+        body->x += dx;
+    }
+
+    /* --- Vertical: nearest floor below (or slope surface just above the feet) and ceiling --- */
+    float left = body->x, right = body->x + body->width;
+    float top = body->y, bottom = body->y + body->height;
+    float footX = body->x + body->width * 0.5f;
+    float floorY = INFINITY;
+    float ceilingY = -INFINITY;
+
+    for (int i = 0; i < count; i++)
+    {
+        const CollisionBox *b = &world->boxes[candidates[i]];
+
+        if (b->flags & (COLLISION_SLOPE_UP | COLLISION_SLOPE_DOWN))
+        {
+            if (footX < b->x || footX > b->x + b->width) continue;
+            float surface = SlopeSurface(b, footX);
+            if (bottom <= surface + COLLISION_SNAP_DISTANCE) floorY = fminf(floorY, surface);
+            continue;
+        }
+
+        if (b->x >= right - COLLISION_EPSILON || b->x + b->width <= left + COLLISION_EPSILON) continue;
+
+        if (b->y >= bottom - stepHeight)
+            floorY = fminf(floorY, b->y);
+        else if ((b->flags & COLLISION_SOLID) && b->y + b->height <= top + COLLISION_EPSILON)
+            ceilingY = fmaxf(ceilingY, b->y + b->height);
+    }
+
+    if (dy >= 0.0f)
+    {
+        float reach = dy + (snapDown ? COLLISION_SNAP_DISTANCE : 0.0f);
+        if (floorY <= bottom + reach)
+        {
+            dy = floorY - bottom;
+            result->landed = true;
+        }
+    }
+    else if (top + dy < ceilingY)
+    {
+        dy = ceilingY - top;
+        result->hitCeiling = true;
+    }
+
+    body->y += dy;
+    result->dx = dx;
+    result->dy = dy;
+
+    if (candidates != stackCandidates) free(candidates);
+}
@@ -0,0 +1,66 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COLLISION_MAX_CANDIDATES 64   // Stack room for a move query; denser spots fall back to the heap
+#define COLLISION_SNAP_DISTANCE  8.0f // How far a grounded body follows floors down, slopes and steps up
+
+typedef enum CollisionFlags {
+    COLLISION_SOLID      = 1 << 0, // Blocks from every side
+    COLLISION_ONE_WAY    = 1 << 1, // Platform: only blocks bodies landing from above
+    COLLISION_SLOPE_UP   = 1 << 2, // Floor rising from bottom-left to top-right
+    COLLISION_SLOPE_DOWN = 1 << 3  // Floor falling from top-left to bottom-right
+} CollisionFlags;
+
+// Axis-aligned box, x/y is the top-left corner (y grows downwards)
+typedef struct CollisionBox {
+    float x, y;
+    float width, height;
+    uint32_t flags;
+} CollisionBox;
+
+// Static boxes plus a uniform-grid broadphase. Cell c owns the box indices
+// cellItems[cellStart[c] .. cellStart[c + 1]). All arrays are read-only, so a
+// world can view data built at runtime or mapped straight from a level file.
+// Queries clamp to itemCount and boxCount rather than trust the tables, so a
+// corrupt file costs wrong collisions, never a read out of bounds.
+typedef struct CollisionWorld {
+    const CollisionBox *boxes;
+    int boxCount;
+
+    float originX, originY;
+    float cellSize;
+    int cols, rows;
+    const uint32_t *cellStart; // cols * rows + 1 entries
+    const uint32_t *cellItems;
+    int itemCount;
+
+    void *storage; // Owned allocation from Collision_Build, NULL for views
+} CollisionWorld;
+
+typedef struct CollisionMove {
+    float dx, dy;   // Movement actually applied
+    bool hitWall;   // Horizontal motion was stopped
+    bool hitCeiling;
+    bool landed;    // Standing on something after the move
+} CollisionMove;
+
+// Copies boxes and builds the grid over their bounds. Returns false on allocation failure.
+bool Collision_Build(CollisionWorld *world, const CollisionBox *boxes, int count, float cellSize);
+void Collision_Free(CollisionWorld *world);
+
+// Indices of boxes overlapping the rectangle (touching counts), without duplicates.
+// Returns how many overlap, which can exceed maxOut: only the first maxOut are
+// written, so a larger result means the caller has to query again with more room.
+int Collision_Query(const CollisionWorld *world, float x, float y, float width, float height,
+                    int *out, int maxOut);
+
+// Sweeps body by (dx, dy), horizontal axis first, stopping at the first
+// contact on each axis. snapDown keeps a grounded body glued to floors and
+// slopes it walks along. Updates body in place.
+void Collision_Move(const CollisionWorld *world, CollisionBox *body, float dx, float dy,
+                    bool snapDown, CollisionMove *result);
+
+#endif
@@ -0,0 +1,155 @@
+#include "gpumem.h"
+#include <stdio.h>
+
+// raylib attaches a 24-bit depth renderbuffer to every render texture;
+// drivers pad it to 32 bits per pixel
+#define DEPTH_BYTES_PER_PIXEL 4
+
+static GpuMemEntry entries[GPUMEM_MAX_ENTRIES];
+static int entryCount;
+static size_t used;
+static size_t budget = GPUMEM_DEFAULT_BUDGET;
+static bool changed;
+
+static const char *FormatName(int format)
+{
+    switch (format)
+    {
+        case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: return "L8";
+        case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: return "LA8";
+        case PIXELFORMAT_UNCOMPRESSED_R5G6B5: return "RGB565";
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8: return "RGB8";
+        case PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: return "RGBA5551";
+        case PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: return "RGBA4";
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: return "RGBA8";
+        case PIXELFORMAT_COMPRESSED_ETC2_RGB: return "ETC2";
+        default: return "-";
+    }
+}
+
+void GpuMem_SetBudget(size_t bytes)
+{
+    budget = bytes;
+}
+
+size_t GpuMem_Budget(void)
+{
+    return budget;
+}
+
+size_t GpuMem_Used(void)
+{
+    return used;
+}
+
+static bool Fits(const char *owner, size_t bytes)
+{
+    if (entryCount < GPUMEM_MAX_ENTRIES && used + bytes <= budget) return true;
+
+    TraceLog(LOG_WARNING, "GPUMEM: Refused %s (%i KB), %i/%i KB in use",
+             owner, (int)(bytes / 1024), (int)(used / 1024), (int)(budget / 1024));
+    return false;
+}
+
+bool GpuMem_Track(GpuMemKind kind, unsigned int id, const char *owner,
+                  int width, int height, int format, size_t bytes)
+{
+    if (!Fits(owner, bytes)) return false;
+
+    entries[entryCount++] = (GpuMemEntry){ kind, id, owner, width, height, format, bytes };
+    used += bytes;
+    changed = true;
+    return true;
+}
+
+void GpuMem_Untrack(GpuMemKind kind, unsigned int id)
+{
+    for (int i = 0; i < entryCount; i++)
+    {
+        if (entries[i].kind != kind || entries[i].id != id) continue;
+
+        used -= entries[i].bytes;
+        entries[i] = entries[--entryCount];
+        changed = true;
+        return;
+    }
+}
+
+Texture2D GpuMem_LoadTexture(Image *image, int format, const char *owner)
+{
+    Texture2D texture = { 0 };
+
+    if (image->format != format) ImageFormat(image, format);
+    size_t bytes = (size_t)GetPixelDataSize(image->width, image->height, image->format);
+
+    if (!Fits(owner, bytes)) return texture;
+
+    texture = LoadTextureFromImage(*image);
+    if (texture.id == 0) return texture;
+
+    GpuMem_Track(GPUMEM_TEXTURE, texture.id, owner, texture.width, texture.height, texture.format, bytes);
+    return texture;
+}
+
+RenderTexture2D GpuMem_LoadRenderTexture(int width, int height, const char *owner)
+{
+    RenderTexture2D target = { 0 };
+    size_t bytes = (size_t)GetPixelDataSize(width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) +
+                   (size_t)width * height * DEPTH_BYTES_PER_PIXEL;
+
+    if (!Fits(owner, bytes)) return target;
+
+    target = LoadRenderTexture(width, height);
+    if (target.id == 0) return target;
+
+    GpuMem_Track(GPUMEM_RENDER_TARGET, target.id, owner, width, height, target.texture.format, bytes);
+    return target;
+}
+
+void GpuMem_UnloadTexture(Texture2D texture)
+{
+    if (texture.id == 0) return;
+    GpuMem_Untrack(GPUMEM_TEXTURE, texture.id);
+    UnloadTexture(texture);
+}
+
+void GpuMem_UnloadRenderTexture(RenderTexture2D target)
+{
+    if (target.id == 0) return;
+    GpuMem_Untrack(GPUMEM_RENDER_TARGET, target.id);
+    UnloadRenderTexture(target);
+}
+
+bool GpuMem_Changed(void)
+{
+    bool was = changed;
+    changed = false;
+    return was;
+}
+
+int GpuMem_Report(char *buffer, int size)
+{
+    static const char *kindNames[] = { "tex", "rt", "buf" };
+    int offset = 0;
+    int lines = 0;
+
+    if (size <= 0) return 0;
+    buffer[0] = '\0';
+
+    for (int i = 0; i < entryCount && offset < size; i++)
+    {
+        const GpuMemEntry *e = &entries[i];
+        offset += snprintf(buffer + offset, size - offset, "%-3s %-10s %4ix%-4i %-8s %6i KB\n",
+                           kindNames[e->kind], e->owner, e->width, e->height,
+                           FormatName(e->format), (int)(e->bytes / 1024));
+        lines++;
+    }
+
+    if (offset < size)
+    {
+        snprintf(buffer + offset, size - offset, "total %i / %i KB",
+                 (int)(used / 1024), (int)(budget / 1024));
+        lines++;
+    }
+    return lines;
+}
@@ -0,0 +1,50 @@
+#ifndef GPUMEM_H
+#define GPUMEM_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define GPUMEM_MAX_ENTRIES     32
+#define GPUMEM_DEFAULT_BUDGET  (16u * 1024u * 1024u)
+
+typedef enum GpuMemKind {
+    GPUMEM_TEXTURE = 0,
+    GPUMEM_RENDER_TARGET, // Color attachment plus depth renderbuffer
+    GPUMEM_BUFFER         // Vertex buffers
+} GpuMemKind;
+
+typedef struct GpuMemEntry {
+    GpuMemKind kind;
+    unsigned int id;
+    const char *owner; // Must outlive the entry, string literals in practice
+    int width;
+    int height;
+    int format;        // raylib PixelFormat, 0 for buffers
+    size_t bytes;
+} GpuMemEntry;
+
+void GpuMem_SetBudget(size_t bytes);
+size_t GpuMem_Budget(void);
+size_t GpuMem_Used(void);
+
+// Records an allocation made elsewhere. Returns false, without recording it,
+// if it would exceed the budget; the caller should free or skip the resource.
+bool GpuMem_Track(GpuMemKind kind, unsigned int id, const char *owner,
+                  int width, int height, int format, size_t bytes);
+void GpuMem_Untrack(GpuMemKind kind, unsigned int id);
+
+// Budget-checked loaders. On refusal they return a zeroed resource (id == 0).
+// GpuMem_LoadTexture converts image to format in place before uploading.
+Texture2D GpuMem_LoadTexture(Image *image, int format, const char *owner);
+RenderTexture2D GpuMem_LoadRenderTexture(int width, int height, const char *owner);
+void GpuMem_UnloadTexture(Texture2D texture);
+void GpuMem_UnloadRenderTexture(RenderTexture2D target);
+
+// True once after any allocation change, so callers can log only on change.
+bool GpuMem_Changed(void);
+
+// One line per entry plus a total line. Returns the number of lines written.
+int GpuMem_Report(char *buffer, int size);
+
+#endif
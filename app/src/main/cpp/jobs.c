@@ -0,0 +1,372 @@
+#define _GNU_SOURCE
+#include "jobs.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define JOBS_MAX_THREADS  (JOBS_MAX_WORKERS + 1) // Workers plus the owning thread
+#define JOBS_SPIN_COUNT   64
+#define JOBS_MAX_CPUS     32
+
+typedef struct Job {
+    JobFunc func;
+    void *data;
+    int begin;
+    int end;
+    JobCounter *counter;
+} Job;
+
+// Chase-Lev deque: the owner pushes and pops at bottom, thieves take from top.
+// Jobs are stored by value; a thief's copy only counts if its CAS on top wins,
+// and the owner never overwrites a slot that a winning thief could still read.
+typedef struct JobDeque {
+    int64_t top;
+    char pad0[64 - sizeof(int64_t)];
+    int64_t bottom;
+    char pad1[64 - sizeof(int64_t)];
+    Job slots[JOBS_DEQUE_SIZE];
+} JobDeque;
+
+typedef struct JobWorker {
+    pthread_t thread;
+    int index;
+} JobWorker;
+
+static JobDeque deques[JOBS_MAX_THREADS];
+static JobWorker workers[JOBS_MAX_WORKERS];
+static cpu_set_t workerCpus; // Shared by every worker when affinity is on
+static bool workersPinned;
+static int32_t startedWorkers;  // Workers past their startup, see Jobs_Init
+static int32_t unpinnedWorkers; // Workers the kernel refused workerCpus to
+static int workerCount;
+static int threadCount;
+static bool running;
+
+static pthread_mutex_t sleepMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sleepCond = PTHREAD_COND_INITIALIZER;
+static int32_t sleepers;
+
+static __thread int threadIndex;
+
+/* =============================
+   DEQUE
+============================= */
+static bool DequePush(JobDeque *d, const Job *job)
+{
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - t >= JOBS_DEQUE_SIZE) return false;
+
+    d->slots[b & (JOBS_DEQUE_SIZE - 1)] = *job;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+static bool DequePop(JobDeque *d, Job *out)
+{
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b)
+    {
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    *out = d->slots[b & (JOBS_DEQUE_SIZE - 1)];
+    if (t == b)
+    {
+        // Last item: race the thieves for it
+        bool won = __atomic_compare_exchange_n(&d->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+static bool DequeSteal(JobDeque *d, Job *out)
+{
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return false;
+
+    *out = d->slots[t & (JOBS_DEQUE_SIZE - 1)];
+    return __atomic_compare_exchange_n(&d->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* =============================
+   SCHEDULING
+============================= */
+static void Execute(const Job *job)
+{
+    job->func(job->data, job->begin, job->end);
+    if (job->counter) __atomic_sub_fetch(&job->counter->pending, 1, __ATOMIC_ACQ_REL);
+}
+
+static bool FindJob(int self, uint32_t *seed, Job *out)
+{
+    if (DequePop(&deques[self], out)) return true;
+
+    // Start stealing at a random victim so thieves spread out
+    *seed = *seed * 1664525u + 1013904223u;
+    int start = (int)((*seed >> 16) % (uint32_t)threadCount);
+    for (int i = 0; i < threadCount; i++)
+    {
+        int victim = (start + i) % threadCount;
+        if (victim == self) continue;
+        if (DequeSteal(&deques[victim], out)) return true;
+    }
+    return false;
+}
+
+static void WakeWorkers(void)
+{
+    // Pairs with the sleeper count bump in WorkerMain so one side always sees the other
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sleepers, __ATOMIC_SEQ_CST) == 0) return;
+
+    pthread_mutex_lock(&sleepMutex);
+    pthread_cond_broadcast(&sleepCond);
+    pthread_mutex_unlock(&sleepMutex);
+}
+
+static bool AnyQueued(void)
+{
+    for (int i = 0; i < threadCount; i++)
+    {
+        if (__atomic_load_n(&deques[i].bottom, __ATOMIC_ACQUIRE) >
+            __atomic_load_n(&deques[i].top, __ATOMIC_ACQUIRE)) return true;
+    }
+    return false;
+}
+
+/* =============================
+   CORE AFFINITY
+============================= */
+// Relative core performance: cpu_capacity where the kernel exposes it,
+// otherwise the maximum frequency. Returns 0 if neither is readable.
+static long ReadCpuCapacity(int cpu)
+{
+    static const char *sources[] = {
+        "/sys/devices/system/cpu/cpu%d/cpu_capacity",
+        "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq",
+    };
+
+    for (int s = 0; s < 2; s++)
+    {
+        char path[96];
+        snprintf(path, sizeof(path), sources[s], cpu);
+
+        FILE *file = fopen(path, "r");
+        if (!file) continue;
+
+        long value = 0;
+        int ok = fscanf(file, "%ld", &value);
+        fclose(file);
+        if (ok == 1 && value > 0) return value;
+    }
+    return 0;
+}
+
+// Collects the cores matching affinity into workerCpus. Returns how many
+// there are, 0 when there is nothing to prefer.
+static int SelectCpus(JobsAffinity affinity)
+{
+    CPU_ZERO(&workerCpus);
+    workersPinned = false;
+    if (affinity == JOBS_AFFINITY_NONE) return 0;
+
+    long capacity[JOBS_MAX_CPUS];
+    long maxCapacity = 0, minCapacity = 0;
+    int cpuCount = (int)sysconf(_SC_NPROCESSORS_CONF);
+    if (cpuCount > JOBS_MAX_CPUS) cpuCount = JOBS_MAX_CPUS;
+
+    for (int c = 0; c < cpuCount; c++)
+    {
+        capacity[c] = ReadCpuCapacity(c);
+        if (capacity[c] > maxCapacity) maxCapacity = capacity[c];
+        if (capacity[c] > 0 && (minCapacity == 0 || capacity[c] < minCapacity)) minCapacity = capacity[c];
+    }
+
+    // Homogeneous or unknown topology: nothing to prefer
+    if (maxCapacity == 0 || maxCapacity == minCapacity) return 0;
+
+    int count = 0;
+    // Big is everything outside the efficiency cluster: on 1+3+4 parts that is
+    // the prime core and the mid cores together, not the prime core alone
+    for (int c = 0; c < cpuCount; c++)
+    {
+        bool big = capacity[c] > minCapacity;
+        bool little = capacity[c] == minCapacity;
+        if ((affinity == JOBS_AFFINITY_BIG && big) || (affinity == JOBS_AFFINITY_LITTLE && little))
+        {
+            CPU_SET(c, &workerCpus);
+            count++;
+        }
+    }
+    workersPinned = count > 0;
+    return count;
+}
+
+static void *WorkerMain(void *arg)
+{
+    JobWorker *worker = (JobWorker *)arg;
+    threadIndex = worker->index;
+    uint32_t seed = 0x9E3779B9u * (uint32_t)(worker->index + 1);
+
+    // The whole matching set, not one core each, so the scheduler can still
+    // balance workers across the cluster
+    if (workersPinned && sched_setaffinity(0, sizeof(workerCpus), &workerCpus) != 0)
+        __atomic_add_fetch(&unpinnedWorkers, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&startedWorkers, 1, __ATOMIC_RELEASE);
+
+    int idle = 0;
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+    {
+        Job job;
+        if (FindJob(threadIndex, &seed, &job))
+        {
+            Execute(&job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < JOBS_SPIN_COUNT)
+        {
+            sched_yield();
+            continue;
+        }
+
+        // Nothing to do for a while: sleep until someone pushes work
+        pthread_mutex_lock(&sleepMutex);
+        __atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&running, __ATOMIC_ACQUIRE) && !AnyQueued())
+            pthread_cond_wait(&sleepCond, &sleepMutex);
+        __atomic_sub_fetch(&sleepers, 1, __ATOMIC_ACQ_REL);
+        pthread_mutex_unlock(&sleepMutex);
+        idle = 0;
+    }
+    return NULL;
+}
+
+/* =============================
+   PUBLIC API
+============================= */
+bool Jobs_Init(int requested, JobsAffinity affinity)
+{
+    if (running) return true;
+
+    if (requested <= 0) requested = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (requested > JOBS_MAX_WORKERS) requested = JOBS_MAX_WORKERS;
+    if (requested < 0) requested = 0;
+
+    // More workers than matching cores would only time-slice on them
+    int matching = SelectCpus(affinity);
+    if (matching > 0 && requested > matching) requested = matching;
+
+    memset(deques, 0, sizeof(deques));
+    threadIndex = 0;
+    workerCount = requested;
+    threadCount = requested + 1;
+    startedWorkers = 0;
+    unpinnedWorkers = 0;
+    running = true;
+
+    bool allCreated = true;
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers[i].index = i + 1;
+        if (pthread_create(&workers[i].thread, NULL, WorkerMain, &workers[i]) != 0)
+        {
+            // Keep the workers that did start
+            workerCount = i;
+            threadCount = i + 1;
+            allCreated = false;
+            break;
+        }
+    }
+
+    // Wait for every worker to apply its affinity so a refusal can be reported
+    while (__atomic_load_n(&startedWorkers, __ATOMIC_ACQUIRE) < workerCount) sched_yield();
+    return allCreated && __atomic_load_n(&unpinnedWorkers, __ATOMIC_ACQUIRE) == 0;
+}
+
+void Jobs_Shutdown(void)
+{
+    if (!running) return;
+
+    pthread_mutex_lock(&sleepMutex);
+    __atomic_store_n(&running, false, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&sleepCond);
+    pthread_mutex_unlock(&sleepMutex);
+
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i].thread, NULL);
+    workerCount = 0;
+    threadCount = 0;
+}
+
+int Jobs_WorkerCount(void)
+{
+    return workerCount;
+}
+
+void Jobs_Run(JobFunc func, void *data, int begin, int end, JobCounter *counter)
+{
+    JobDeque *d = &deques[threadIndex];
+
+    // No workers or a full deque: run inline
+    if (workerCount == 0 ||
+        __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - __atomic_load_n(&d->top, __ATOMIC_ACQUIRE) >= JOBS_DEQUE_SIZE)
+    {
+        func(data, begin, end);
+        return;
+    }
+
+    if (counter) __atomic_add_fetch(&counter->pending, 1, __ATOMIC_ACQ_REL);
+
+    Job job = { func, data, begin, end, counter };
+
+    // Only the owner pushes, so the capacity check above still holds
+    DequePush(d, &job);
+    WakeWorkers();
+}
+
+void Jobs_ParallelFor(JobFunc func, void *data, int count, int grain, JobCounter *counter)
+{
+    if (count <= 0) return;
+    if (grain <= 0)
+    {
+        // About four chunks per thread balances stealing against overhead
+        grain = count / ((workerCount + 1) * 4);
+        if (grain < 1) grain = 1;
+    }
+
+    if (workerCount == 0 || count <= grain)
+    {
+        func(data, 0, count);
+        return;
+    }
+
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        int end = (begin + grain < count) ? begin + grain : count;
+        Jobs_Run(func, data, begin, end, counter);
+    }
+}
+
+void Jobs_Wait(JobCounter *counter)
+{
+    uint32_t seed = 0x2545F491u;
+    while (__atomic_load_n(&counter->pending, __ATOMIC_ACQUIRE) > 0)
+    {
+        Job job;
+        if (threadCount > 0 && FindJob(threadIndex, &seed, &job)) Execute(&job);
+        else sched_yield();
+    }
+}
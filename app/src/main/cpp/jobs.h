@@ -0,0 +1,46 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define JOBS_MAX_WORKERS  8
+#define JOBS_DEQUE_SIZE   256  // Per thread, must be a power of two
+
+typedef enum JobsAffinity {
+    JOBS_AFFINITY_NONE = 0, // Let the scheduler decide
+    JOBS_AFFINITY_BIG,      // Keep workers off the efficiency cores
+    JOBS_AFFINITY_LITTLE    // Keep workers on the efficiency cores (lowest capacity)
+} JobsAffinity;
+
+// Work on the index range [begin, end)
+typedef void (*JobFunc)(void *data, int begin, int end);
+
+// Counts jobs still in flight. Zero-initialize, pass to Jobs_Run/ParallelFor,
+// then Jobs_Wait on it. Jobs may wait on other counters to express dependencies.
+typedef struct JobCounter {
+    int32_t pending;
+} JobCounter;
+
+// workerCount <= 0 picks one worker per online core minus the calling thread.
+// With an affinity, workers may run on any matching core and there are never
+// more of them than matching cores.
+// The calling thread becomes thread 0 and must be the one that calls Jobs_Wait.
+// Returns false if a worker could not be created or was refused its affinity;
+// the pool still runs with the workers it has (see Jobs_WorkerCount).
+bool Jobs_Init(int workerCount, JobsAffinity affinity);
+void Jobs_Shutdown(void);
+
+int Jobs_WorkerCount(void);
+
+// Queues a single job on the calling thread's deque. Runs it inline if the deque is full.
+void Jobs_Run(JobFunc func, void *data, int begin, int end, JobCounter *counter);
+
+// Splits [0, count) into chunks of grain indices (grain <= 0 picks one).
+// Ranges that fit in a single chunk run inline without touching the queues.
+void Jobs_ParallelFor(JobFunc func, void *data, int count, int grain, JobCounter *counter);
+
+// Executes queued or stolen jobs until the counter drains.
+void Jobs_Wait(JobCounter *counter);
+
+#endif
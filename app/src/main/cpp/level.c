@@ -0,0 +1,294 @@
+#define _POSIX_C_SOURCE 200809L
+#include "level.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(PLATFORM_ANDROID)
+#include <android/asset_manager.h>
+#endif
+
+#ifndef LEVEL_VERIFY_PAYLOAD
+#if defined(NDEBUG)
+#define LEVEL_VERIFY_PAYLOAD 0
+#else
+#define LEVEL_VERIFY_PAYLOAD 1
+#endif
+#endif
+
+#define HEADER_CHECKED_BYTES offsetof(LevelHeader, headerChecksum)
+
+// The file layout is the struct layout, so the structs must stay padding-free
+typedef char LevelHeaderNoPadding[(sizeof(LevelHeader) == HEADER_CHECKED_BYTES + 4) ? 1 : -1];
+typedef char LevelParallaxNoPadding[(sizeof(LevelParallax) == 7 * 4) ? 1 : -1];
+typedef char LevelBoxNoPadding[(sizeof(CollisionBox) == 5 * 4) ? 1 : -1];
+
+static uint32_t Checksum(const unsigned char *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool SectionFits(LevelSection section, size_t recordSize, size_t fileSize)
+{
+    if (section.count == 0) return true;
+    if (section.offset < sizeof(LevelHeader) || section.offset % 4 != 0) return false;
+    return (uint64_t)section.offset + (uint64_t)section.count * recordSize <= fileSize;
+}
+
+static bool ValidateHeader(const LevelHeader *h, size_t size)
+{
+    if (h->magic != LEVEL_MAGIC || h->version != LEVEL_VERSION) return false;
+    if (h->fileSize != size) return false;
+    if (h->headerChecksum != Checksum((const unsigned char *)h, HEADER_CHECKED_BYTES)) return false;
+    if (!(h->worldWidth > 0.0f && h->worldWidth <= LEVEL_MAX_WORLD_WIDTH)) return false;
+    if (h->birds.count > LEVEL_MAX_BIRDS) return false;
+
+    if (!SectionFits(h->boxes, sizeof(CollisionBox), size) ||
+        !SectionFits(h->cellStart, sizeof(uint32_t), size) ||
+        !SectionFits(h->cellItems, sizeof(uint32_t), size) ||
+        !SectionFits(h->stars, sizeof(LevelStar), size) ||
+        !SectionFits(h->birds, sizeof(LevelBird), size) ||
+        !SectionFits(h->parallax, sizeof(LevelParallax), size)) return false;
+
+    // A level without boxes has no grid either
+    if (h->boxes.count == 0) return h->cellStart.count == 0 && h->cellItems.count == 0;
+
+    if (h->gridCols <= 0 || h->gridRows <= 0 || !(h->gridCellSize > 0.0f)) return false;
+    if ((uint64_t)h->gridCols * (uint64_t)h->gridRows + 1 != h->cellStart.count) return false;
+
+    // The last prefix-sum entry has to account for every item
+    const uint32_t *cellStart = (const uint32_t *)((const unsigned char *)h + h->cellStart.offset);
+    return cellStart[h->cellStart.count - 1] == h->cellItems.count;
+}
+
+bool Level_VerifyPayload(const Level *level)
+{
+    if (!level->header) return false;
+    return level->header->payloadChecksum ==
+           Checksum((const unsigned char *)level->data + sizeof(LevelHeader), level->size - sizeof(LevelHeader));
+}
+
+static const void *SectionData(const Level *level, LevelSection section)
+{
+    return section.count ? (const unsigned char *)level->data + section.offset : NULL;
+}
+
+bool Level_OpenMemory(Level *level, const void *data, size_t size, bool owned)
+{
+    memset(level, 0, sizeof(Level));
+
+    // Records are read in place, so the base has to be aligned like them
+    if (!data || size < sizeof(LevelHeader) || ((uintptr_t)data & 3) != 0) return false;
+
+    const LevelHeader *header = (const LevelHeader *)data;
+    if (!ValidateHeader(header, size)) return false;
+
+    level->header = header;
+    level->data = data;
+    level->size = size;
+
+#if LEVEL_VERIFY_PAYLOAD
+    if (!Level_VerifyPayload(level))
+    {
+        memset(level, 0, sizeof(Level));
+        return false;
+    }
+#endif
+
+    level->boxes = SectionData(level, header->boxes);
+    level->stars = SectionData(level, header->stars);
+    level->birds = SectionData(level, header->birds);
+    level->parallax = SectionData(level, header->parallax);
+    level->starCount = (int)header->stars.count;
+    level->birdCount = (int)header->birds.count;
+    level->parallaxCount = (int)header->parallax.count;
+
+    level->source = LEVEL_SOURCE_MEMORY;
+    level->handle = owned ? (void *)data : NULL;
+    return true;
+}
+
+bool Level_OpenFile(Level *level, const char *path)
+{
+    memset(level, 0, sizeof(Level));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(LevelHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    if (!Level_OpenMemory(level, mapped, size, false))
+    {
+        munmap(mapped, size);
+        return false;
+    }
+
+    level->source = LEVEL_SOURCE_MAPPED;
+    return true;
+}
+
+#if defined(PLATFORM_ANDROID)
+bool Level_OpenAsset(Level *level, void *assetManager, const char *name)
+{
+    memset(level, 0, sizeof(Level));
+    if (!assetManager) return false;
+
+    AAsset *asset = AAssetManager_open((AAssetManager *)assetManager, name, AASSET_MODE_BUFFER);
+    if (!asset) return false;
+
+    const void *data = AAsset_getBuffer(asset);
+    size_t size = (size_t)AAsset_getLength(asset);
+
+    if (!data || !Level_OpenMemory(level, data, size, false))
+    {
+        AAsset_close(asset);
+        return false;
+    }
+
+    level->source = LEVEL_SOURCE_ASSET;
+    level->handle = asset;
+    return true;
+}
+#endif
+
+void Level_Close(Level *level)
+{
+    switch (level->source)
+    {
+        case LEVEL_SOURCE_MAPPED:
+            munmap((void *)level->data, level->size);
+            break;
+        case LEVEL_SOURCE_MEMORY:
+            free(level->handle);
+            break;
+#if defined(PLATFORM_ANDROID)
+        case LEVEL_SOURCE_ASSET:
+            AAsset_close((AAsset *)level->handle);
+            break;
+#endif
+        default:
+            break;
+    }
+    memset(level, 0, sizeof(Level));
+}
+
+void Level_CollisionWorld(const Level *level, CollisionWorld *world)
+{
+    memset(world, 0, sizeof(CollisionWorld));
+    if (!level->header || level->header->boxes.count == 0) return;
+
+    const LevelHeader *h = level->header;
+    world->boxes = level->boxes;
+    world->boxCount = (int)h->boxes.count;
+    world->originX = h->gridOriginX;
+    world->originY = h->gridOriginY;
+    world->cellSize = h->gridCellSize;
+    world->cols = h->gridCols;
+    world->rows = h->gridRows;
+    world->cellStart = SectionData(level, h->cellStart);
+    world->cellItems = SectionData(level, h->cellItems);
+    world->itemCount = (int)h->cellItems.count;
+}
+
+static LevelSection PlaceSection(size_t *offset, int count, size_t recordSize)
+{
+    LevelSection section = { 0, 0 };
+    if (count <= 0) return section;
+
+    section.offset = (uint32_t)*offset;
+    section.count = (uint32_t)count;
+    *offset += (size_t)count * recordSize;
+    return section;
+}
+
+void *Level_Pack(const LevelDesc *desc, size_t *size)
+{
+    if (!(desc->worldWidth > 0.0f && desc->worldWidth <= LEVEL_MAX_WORLD_WIDTH)) return NULL;
+    if (desc->birdCount > LEVEL_MAX_BIRDS) return NULL;
+
+    CollisionWorld world;
+    if (!Collision_Build(&world, desc->boxes, desc->boxCount, desc->cellSize)) return NULL;
+
+    int cellCount = world.boxCount ? world.cols * world.rows + 1 : 0;
+    int itemCount = world.boxCount ? (int)world.cellStart[cellCount - 1] : 0;
+
+    LevelHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LEVEL_MAGIC;
+    header.version = LEVEL_VERSION;
+    header.worldWidth = desc->worldWidth;
+    header.groundY = desc->groundY;
+    header.spawnX = desc->spawnX;
+    header.spawnY = desc->spawnY;
+    header.transitionCenter = desc->transitionCenter;
+    header.transitionWidth = desc->transitionWidth;
+    header.dayAmbient = desc->dayAmbient;
+    header.nightAmbient = desc->nightAmbient;
+    header.gridOriginX = world.originX;
+    header.gridOriginY = world.originY;
+    header.gridCellSize = world.cellSize;
+    header.gridCols = world.cols;
+    header.gridRows = world.rows;
+
+    size_t offset = sizeof(LevelHeader);
+    header.boxes = PlaceSection(&offset, world.boxCount, sizeof(CollisionBox));
+    header.cellStart = PlaceSection(&offset, cellCount, sizeof(uint32_t));
+    header.cellItems = PlaceSection(&offset, itemCount, sizeof(uint32_t));
+    header.stars = PlaceSection(&offset, desc->starCount, sizeof(LevelStar));
+    header.birds = PlaceSection(&offset, desc->birdCount, sizeof(LevelBird));
+    header.parallax = PlaceSection(&offset, desc->parallaxCount, sizeof(LevelParallax));
+
+    if (offset > UINT32_MAX)
+    {
+        Collision_Free(&world);
+        return NULL;
+    }
+    header.fileSize = (uint32_t)offset;
+
+    unsigned char *file = malloc(offset);
+    if (!file)
+    {
+        Collision_Free(&world);
+        return NULL;
+    }
+
+    if (world.boxCount)
+    {
+        memcpy(file + header.boxes.offset, world.boxes, sizeof(CollisionBox) * (size_t)world.boxCount);
+        memcpy(file + header.cellStart.offset, world.cellStart, sizeof(uint32_t) * (size_t)cellCount);
+        memcpy(file + header.cellItems.offset, world.cellItems, sizeof(uint32_t) * (size_t)itemCount);
+    }
+    if (desc->starCount > 0)
+        memcpy(file + header.stars.offset, desc->stars, sizeof(LevelStar) * (size_t)desc->starCount);
+    if (desc->birdCount > 0)
+        memcpy(file + header.birds.offset, desc->birds, sizeof(LevelBird) * (size_t)desc->birdCount);
+    if (desc->parallaxCount > 0)
+        memcpy(file + header.parallax.offset, desc->parallax, sizeof(LevelParallax) * (size_t)desc->parallaxCount);
+    Collision_Free(&world);
+
+    header.payloadChecksum = Checksum(file + sizeof(LevelHeader), offset - sizeof(LevelHeader));
+    header.headerChecksum = Checksum((const unsigned char *)&header, HEADER_CHECKED_BYTES);
+    memcpy(file, &header, sizeof(LevelHeader));
+
+    *size = offset;
+    return file;
+}
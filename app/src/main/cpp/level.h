@@ -0,0 +1,148 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "collision.h"
+
+#define LEVEL_MAGIC      0x4C4D5555u // "UUML" in little-endian byte order
+#define LEVEL_VERSION    1
+#define LEVEL_EXTENSION  "umgl"
+
+#define LEVEL_MAX_BIRDS        65536        // Spawn table entries
+#define LEVEL_MAX_WORLD_WIDTH  16777216.0f  // 2^24: past this float positions lose whole pixels
+
+// Every record is built from 4-byte fields, so sections stay 4-byte aligned
+// and can be read straight out of a mapping. All values are little-endian.
+typedef struct LevelSection {
+    uint32_t offset; // From the start of the file
+    uint32_t count;  // Records, not bytes
+} LevelSection;
+
+typedef struct LevelStar {
+    float x, y;
+    float phase, speed;
+} LevelStar;
+
+typedef struct LevelBird {
+    float x, y;
+    float speed, phase;
+} LevelBird;
+
+typedef enum LevelParallaxShape {
+    LEVEL_PARALLAX_TRIANGLE = 0, // Peak at y, base size below, spacing wide
+    LEVEL_PARALLAX_CIRCLE        // Centre at y, radius size
+} LevelParallaxShape;
+
+typedef struct LevelParallax {
+    float factor;  // Scroll speed relative to the camera
+    float spacing; // Distance between repeats
+    float y;
+    float size;
+    uint32_t shape;
+    uint32_t count;
+    uint8_t color[4];
+} LevelParallax;
+
+typedef struct LevelHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t payloadChecksum; // FNV-1a over [sizeof(LevelHeader), fileSize)
+
+    float worldWidth;
+    float groundY;
+    float spawnX, spawnY;
+    float transitionCenter, transitionWidth; // Day to night across the world
+    float dayAmbient, nightAmbient;
+
+    // Collision broadphase, laid out exactly as CollisionWorld expects it
+    float gridOriginX, gridOriginY;
+    float gridCellSize;
+    int32_t gridCols, gridRows;
+
+    LevelSection boxes;     // CollisionBox
+    LevelSection cellStart; // uint32_t, gridCols * gridRows + 1
+    LevelSection cellItems; // uint32_t
+    LevelSection stars;     // LevelStar
+    LevelSection birds;     // LevelBird, spawn positions
+    LevelSection parallax;  // LevelParallax, back to front
+
+    uint32_t headerChecksum; // FNV-1a over every header byte before this field
+} LevelHeader;
+
+typedef enum LevelSource {
+    LEVEL_SOURCE_NONE = 0,
+    LEVEL_SOURCE_ASSET,  // AAsset_getBuffer, Android only
+    LEVEL_SOURCE_MAPPED, // mmap of a file
+    LEVEL_SOURCE_MEMORY  // Caller buffer, freed on close if owned
+} LevelSource;
+
+// Typed views into the level data. Nothing is copied; the pointers stay
+// valid until Level_Close.
+typedef struct Level {
+    const LevelHeader *header;
+    const CollisionBox *boxes;
+    const LevelStar *stars;
+    const LevelBird *birds;
+    const LevelParallax *parallax;
+    int starCount;
+    int birdCount;
+    int parallaxCount;
+
+    LevelSource source;
+    const void *data;
+    size_t size;
+    void *handle; // AAsset for assets, the owned buffer for memory levels
+} Level;
+
+// Everything the packer needs to produce a level file
+typedef struct LevelDesc {
+    float worldWidth;
+    float groundY;
+    float spawnX, spawnY;
+    float transitionCenter, transitionWidth;
+    float dayAmbient, nightAmbient;
+    float cellSize;
+
+    const CollisionBox *boxes;
+    int boxCount;
+    const LevelStar *stars;
+    int starCount;
+    const LevelBird *birds;
+    int birdCount;
+    const LevelParallax *parallax;
+    int parallaxCount;
+} LevelDesc;
+
+// Validates the header and section bounds, which costs the same for any level
+// size. The payload checksum is only walked when LEVEL_VERIFY_PAYLOAD is set
+// (debug builds by default); without it, collision queries still stay inside
+// the grid sections whatever they hold. owned hands data to the level, freed
+// on close.
+bool Level_OpenMemory(Level *level, const void *data, size_t size, bool owned);
+
+// Maps the file read-only and opens it in place.
+bool Level_OpenFile(Level *level, const char *path);
+
+#if defined(PLATFORM_ANDROID)
+// Opens an asset with AASSET_MODE_BUFFER. Stored (uncompressed) assets come
+// back as a view of the mapped APK; compressed ones are inflated by the OS.
+bool Level_OpenAsset(Level *level, void *assetManager, const char *name);
+#endif
+
+void Level_Close(Level *level);
+
+// Checks the payload checksum. Walks the whole file.
+bool Level_VerifyPayload(const Level *level);
+
+// Points world at the level's grid in place. The view owns nothing, so
+// Collision_Free on it only clears it.
+void Level_CollisionWorld(const Level *level, CollisionWorld *world);
+
+// Builds a level file in memory (malloc'd). Returns NULL on failure,
+// including a world or bird table over the LEVEL_MAX_* limits.
+void *Level_Pack(const LevelDesc *desc, size_t *size);
+
+#endif
@@ -1,8 +1,21 @@
 #include <android_native_app_glue.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+#include "audio.h"
 #include "chat.h"
+#include "collision.h"
+#include "gpumem.h"
+#include "jobs.h"
+#include "level.h"
+#include "net.h"
+#include "rollback.h"
+#include "savestate.h"
+#include "sprites.h"
 
 #if defined(PLATFORM_ANDROID)
 #include <jni.h>
@@ -16,15 +29,26 @@ struct android_app *GetAndroidApp(void);
 ============================= */
 #define SCREEN_WIDTH   480
 #define SCREEN_HEIGHT  800
-#define WORLD_WIDTH    4000.0f
-#define GROUND_Y       520.0f
 
-#define GRAVITY        0.6f
-#define JUMP_VELOCITY -12.0f
-#define MAX_JUMPS      2
+#define LOCAL_PLAYER   0 // Movement rules and constants live in sim.h
 
-#define DAY_AMBIENT    0.40f
-#define NIGHT_AMBIENT  0.75f
+#define FOOTSTEP_INTERVAL 0.28f
+
+// World layout, lighting included, comes from this asset, packed from
+// tools/levels/meadow.txt by tools/levelpack
+#define LEVEL_ASSET    "levels/meadow." LEVEL_EXTENSION
+
+// Relay server for multiplayer, an IPv4 literal. Empty plays offline.
+#ifndef NET_SERVER_HOST
+#define NET_SERVER_HOST ""
+#endif
+#ifndef NET_SERVER_PORT
+#define NET_SERVER_PORT NET_DEFAULT_PORT
+#endif
+
+#ifndef DEBUG_HUD
+#define DEBUG_HUD      0
+#endif
 
 
 static inline int GetSafeTouchId(int index)
@@ -195,27 +219,29 @@ void DrawPlayer(Vector2 pos, Vector2 dir, float speed, float time)
 /* =============================
    STARS
 ============================= */
-typedef struct { Vector2 pos; float phase, speed; } Star;
-#define STAR_COUNT 18
-
-Star stars[STAR_COUNT] = {
-        {{40,60},0,1.2},{{120,90},1.1,0.9},{{200,50},2.3,1.4},
-        {{280,110},0.7,1.0},{{360,70},2.9,0.8},{{430,100},1.6,1.3},
-        {{90,160},2.1,0.7},{{170,140},0.4,1.1},{{260,180},1.8,0.9},
-        {{350,150},2.6,1.2},{{420,200},0.9,0.8},
-        {{60,240},1.5,1.0},{{140,260},2.8,0.7},{{220,230},0.2,1.4},
-        {{310,270},1.9,0.9},{{390,250},0.6,1.1},{{450,300},2.4,0.8},
-        {{300,60},1.3,1.0}
-};
-
-void DrawStars(float nightT, float time)
+// Stars never move, so they are drawn straight from the level data
+static SpriteInstance starInstances[SPRITES_MAX_INSTANCES];
+
+void DrawStars(const LevelStar *stars, int starCount, float nightT, float time)
 {
     if (nightT <= 0.01f) return;
+    if (starCount > SPRITES_MAX_INSTANCES) starCount = SPRITES_MAX_INSTANCES;
+
     BeginBlendMode(BLEND_ADDITIVE);
-    for (int i = 0; i < STAR_COUNT; i++)
+    if (Sprites_Available())
     {
-        float twinkle = 0.6f + 0.4f * sinf(time * stars[i].speed + stars[i].phase);
-        DrawCircleV(stars[i].pos, 2, Fade(RAYWHITE, nightT * twinkle));
+        for (int i = 0; i < starCount; i++)
+            starInstances[i] = (SpriteInstance){ stars[i].x, stars[i].y, 2.0f,
+                                                 stars[i].phase, stars[i].speed, { 245, 245, 245, 255 } };
+        Sprites_Draw(SPRITE_CLASS_STAR, starInstances, starCount, time, nightT);
+    }
+    else
+    {
+        for (int i = 0; i < starCount; i++)
+        {
+            float twinkle = 0.6f + 0.4f * sinf(time * stars[i].speed + stars[i].phase);
+            DrawCircleV((Vector2){ stars[i].x, stars[i].y }, 2, Fade(RAYWHITE, nightT * twinkle));
+        }
     }
     EndBlendMode();
 }
@@ -224,20 +250,48 @@ void DrawStars(float nightT, float time)
    BIRDS
 ============================= */
 typedef struct { float x, y, speed, phase; } Bird;
-#define BIRD_COUNT 6
 
-Bird birds[BIRD_COUNT] = {
-        { -60, 120, 0.9f, 0.0f },
-        { -220, 160, 0.7f, 1.2f },
-        { -140,  95, 1.1f, 2.1f },
-        { -360, 140, 0.8f, 0.6f },
-        { -520, 110, 1.0f, 2.7f },
-        { -680, 150, 0.75f, 1.8f }
-};
+// Spawned from the level's table (up to LEVEL_MAX_BIRDS), then moved every frame
+static Bird *birds;
+static SpriteInstance *birdInstances;
+static int birdCount;
 
-void UpdateBirds(float time)
+static bool SpawnBirds(const LevelBird *spawns, int count)
 {
-    for (int i = 0; i < BIRD_COUNT; i++)
+    birds = malloc(sizeof(Bird) * (size_t)(count > 0 ? count : 1));
+    birdInstances = malloc(sizeof(SpriteInstance) * (size_t)(count > 0 ? count : 1));
+    if (!birds || !birdInstances)
+    {
+        free(birds);
+        free(birdInstances);
+        birds = NULL;
+        birdInstances = NULL;
+        return false;
+    }
+
+    birdCount = count;
+    for (int i = 0; i < birdCount; i++)
+        birds[i] = (Bird){ spawns[i].x, spawns[i].y, spawns[i].speed, spawns[i].phase };
+    return true;
+}
+
+static void FreeBirds(void)
+{
+    free(birds);
+    free(birdInstances);
+    birds = NULL;
+    birdInstances = NULL;
+    birdCount = 0;
+}
+
+// Smallest chunk worth handing to a worker: about 5 us of updates, the cost of
+// waking one (tools/jobsbench). Smaller flocks update on the calling thread.
+#define BIRD_MIN_GRAIN 512
+
+static void UpdateBirdRange(void *data, int begin, int end)
+{
+    float time = *(const float *)data;
+    for (int i = begin; i < end; i++)
     {
         birds[i].x += birds[i].speed;
         birds[i].y += sinf(time * 1.2f + birds[i].phase) * 0.3f;
@@ -245,12 +299,41 @@ void UpdateBirds(float time)
     }
 }
 
+void UpdateBirds(float time)
+{
+    // One chunk per thread, so a big flock splits evenly instead of by a fixed size
+    int threads = Jobs_WorkerCount() + 1;
+    int grain = (birdCount + threads - 1) / threads;
+    if (grain < BIRD_MIN_GRAIN) grain = BIRD_MIN_GRAIN;
+
+    JobCounter counter = {0};
+    Jobs_ParallelFor(UpdateBirdRange, &time, birdCount, grain, &counter);
+    Jobs_Wait(&counter);
+}
+
 void DrawBirds(float dayT, float time)
 {
     if (dayT <= 0.01f) return;
+
+    if (Sprites_Available())
+    {
+        for (int i = 0; i < birdCount; i++)
+            birdInstances[i] = (SpriteInstance){ birds[i].x, birds[i].y, 1.0f,
+                                                 birds[i].phase, 6.0f, { 0, 0, 0, 255 } };
+
+        // The instance buffer holds SPRITES_MAX_INSTANCES; bigger flocks take several draws
+        for (int first = 0; first < birdCount; first += SPRITES_MAX_INSTANCES)
+        {
+            int count = birdCount - first;
+            if (count > SPRITES_MAX_INSTANCES) count = SPRITES_MAX_INSTANCES;
+            Sprites_Draw(SPRITE_CLASS_BIRD, birdInstances + first, count, time, dayT * 0.8f);
+        }
+        return;
+    }
+
     Color c = Fade(BLACK, dayT * 0.8f);
 
-    for (int i = 0; i < BIRD_COUNT; i++)
+    for (int i = 0; i < birdCount; i++)
     {
         float flap = 1.0f + sinf(time * 6.0f + birds[i].phase);
         DrawLine(birds[i].x, birds[i].y,
@@ -260,71 +343,598 @@ void DrawBirds(float dayT, float time)
     }
 }
 
+/* =============================
+   GROUND BAKE (CPU, PARALLEL)
+============================= */
+#define GROUND_TEX_HEIGHT  200
+#define GROUND_MAX_WIDTH   8192     // One texture spans the world; GLES 2 devices go at least this wide
+#define GROUND_PEBBLES     400
+
+typedef struct { int x, y, radius; } Pebble;
+
+typedef struct {
+    Color *pixels;
+    int width;
+    int *columnTop; // One per 4-pixel column
+    Pebble pebbles[GROUND_PEBBLES];
+} GroundBake;
+
+static inline Color BlendOver(Color dst, Color src, float alpha)
+{
+    return (Color){
+        (unsigned char)(src.r * alpha + dst.r * (1.0f - alpha)),
+        (unsigned char)(src.g * alpha + dst.g * (1.0f - alpha)),
+        (unsigned char)(src.b * alpha + dst.b * (1.0f - alpha)),
+        255
+    };
+}
+
+static void BakeGroundRows(void *data, int begin, int end)
+{
+    GroundBake *bake = (GroundBake *)data;
+    int width = bake->width;
+
+    for (int y = begin; y < end; y++)
+    {
+        // The old render-texture bake showed up flipped on screen; keep that look
+        Color *row = bake->pixels + (GROUND_TEX_HEIGHT - 1 - y) * width;
+
+        for (int x = 0; x < width; x++)
+            row[x] = (y >= bake->columnTop[x / 4]) ? BlendOver(DARKBROWN, BROWN, 0.75f) : DARKBROWN;
+
+        for (int i = 0; i < GROUND_PEBBLES; i++)
+        {
+            const Pebble *p = &bake->pebbles[i];
+            int dy = y - p->y;
+            if (dy < -p->radius || dy > p->radius) continue;
+
+            int span = (int)sqrtf((float)(p->radius * p->radius - dy * dy));
+            int x0 = (p->x - span < 0) ? 0 : p->x - span;
+            int x1 = (p->x + span >= width) ? width - 1 : p->x + span;
+            for (int x = x0; x <= x1; x++) row[x] = BlendOver(row[x], DARKGRAY, 0.35f);
+        }
+    }
+}
+
+static Texture2D BakeGroundTexture(float worldWidth)
+{
+    static GroundBake bake;
+    double start = GetTime();
+
+    Image image = GenImageColor((int)worldWidth, GROUND_TEX_HEIGHT, DARKBROWN);
+    bake.pixels = (Color *)image.data;
+    bake.width = (int)worldWidth;
+
+    int columns = bake.width / 4 + 1;
+    bake.columnTop = malloc(sizeof(int) * columns);
+    if (!bake.columnTop)
+    {
+        UnloadImage(image);
+        return (Texture2D){ 0 };
+    }
+
+    for (int c = 0; c < columns; c++)
+    {
+        int x = c * 4;
+        bake.columnTop[c] = (int)(40 + sinf(x * 0.03f) * 6 + cosf(x * 0.11f) * 3);
+    }
+
+    // GetRandomValue is not thread safe, so the scatter is drawn up front
+    for (int i = 0; i < GROUND_PEBBLES; i++)
+    {
+        bake.pebbles[i].x = GetRandomValue(0, bake.width);
+        bake.pebbles[i].y = GetRandomValue(80, 180);
+        bake.pebbles[i].radius = GetRandomValue(2, 4);
+    }
+
+    JobCounter counter = {0};
+    Jobs_ParallelFor(BakeGroundRows, &bake, GROUND_TEX_HEIGHT, 8, &counter);
+    Jobs_Wait(&counter);
+    free(bake.columnTop);
+    double baked = GetTime();
+
+    // Opaque static bake: RGB565 halves the footprint with no visible loss on dirt
+    Texture2D texture = GpuMem_LoadTexture(&image, PIXELFORMAT_UNCOMPRESSED_R5G6B5, "ground");
+    UnloadImage(image);
+
+    TraceLog(LOG_INFO, "GROUND: Baked %ix%i on %i threads in %.2f ms (upload %.2f ms)",
+             bake.width, GROUND_TEX_HEIGHT, Jobs_WorkerCount() + 1,
+             (baked - start) * 1000.0, (GetTime() - baked) * 1000.0);
+    return texture;
+}
+
+/* =============================
+   SKY GRADIENT
+============================= */
+// The sky only varies vertically, so a 1-pixel-wide strip stretched across
+// the screen stands in for a full-screen render target
+static Texture2D BakeSkyTexture(void)
+{
+    Image image = GenImageColor(1, SCREEN_HEIGHT, BLANK);
+    Color *pixels = (Color *)image.data;
+
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        // Dark at the top, as the old render-texture bake showed on screen
+        float ty = (float)(SCREEN_HEIGHT - 1 - y) / SCREEN_HEIGHT;
+        pixels[y] = ColorLerp(SKYBLUE, (Color){30,50,120,255}, ty);
+    }
+
+    // RGB565 bands on a slow gradient; at 1 pixel wide RGB8 costs next to nothing
+    Texture2D texture = GpuMem_LoadTexture(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8, "sky");
+    UnloadImage(image);
+
+    if (texture.id > 0)
+    {
+        SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+        SetTextureWrap(texture, TEXTURE_WRAP_CLAMP);
+    }
+    return texture;
+}
+
+/* =============================
+   LEVEL
+============================= */
+static Level level;
+static CollisionWorld levelWorld; // View into level, owns nothing
+static int *levelVisible;         // DrawLevel's query buffer, one slot per box
+
+static const char *LevelSourceName(LevelSource source)
+{
+    switch (source)
+    {
+        case LEVEL_SOURCE_ASSET: return "asset";
+        case LEVEL_SOURCE_MAPPED: return "mapped file";
+        default: return "memory";
+    }
+}
+
+// Opens the level in place. The packed asset is the only copy of the layout.
+static bool LoadLevel(void)
+{
+    double start = GetTime();
+    bool opened = false;
+
+#if defined(PLATFORM_ANDROID)
+    struct android_app *app = GetAndroidApp();
+    if (app && app->activity) opened = Level_OpenAsset(&level, app->activity->assetManager, LEVEL_ASSET);
+#else
+    opened = Level_OpenFile(&level, LEVEL_ASSET);
+#endif
+
+    if (!opened)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: %s missing or invalid", LEVEL_ASSET);
+        return false;
+    }
+
+    if (level.header->worldWidth > GROUND_MAX_WIDTH)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: World is %.0f px wide, the ground texture allows %i",
+                 level.header->worldWidth, GROUND_MAX_WIDTH);
+        Level_Close(&level);
+        return false;
+    }
+
+    Level_CollisionWorld(&level, &levelWorld);
+
+    // Room for every box, so a dense screen can never drop draws
+    levelVisible = malloc(sizeof(int) * (size_t)(levelWorld.boxCount > 0 ? levelWorld.boxCount : 1));
+    if (!levelVisible)
+    {
+        Level_Close(&level);
+        return false;
+    }
+    if (!SpawnBirds(level.birds, level.birdCount))
+    {
+        free(levelVisible);
+        levelVisible = NULL;
+        Level_Close(&level);
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "LEVEL: Opened %i bytes (%s, %i boxes) in %.1f us",
+             (int)level.size, LevelSourceName(level.source), levelWorld.boxCount, (GetTime() - start) * 1e6);
+    return true;
+}
+
+// Only what the broadphase finds inside the camera window gets drawn.
+// The ground box sits under the ground texture, which is drawn afterwards.
+void DrawLevel(float cameraX)
+{
+    int count = Collision_Query(&levelWorld, cameraX, 0, SCREEN_WIDTH, SCREEN_HEIGHT,
+                                levelVisible, levelWorld.boxCount);
+
+    for (int i = 0; i < count; i++)
+    {
+        const CollisionBox *b = &levelWorld.boxes[levelVisible[i]];
+        float x = b->x - cameraX;
+
+        if (b->flags & COLLISION_SLOPE_UP)
+            DrawTriangle((Vector2){x + b->width, b->y}, (Vector2){x, b->y + b->height},
+                         (Vector2){x + b->width, b->y + b->height}, BROWN);
+        else if (b->flags & COLLISION_SLOPE_DOWN)
+            DrawTriangle((Vector2){x, b->y}, (Vector2){x, b->y + b->height},
+                         (Vector2){x + b->width, b->y + b->height}, BROWN);
+        else if (b->flags & COLLISION_ONE_WAY)
+            DrawRectangleRec((Rectangle){x, b->y, b->width, b->height}, DARKBROWN);
+        else
+        {
+            DrawRectangleRec((Rectangle){x, b->y, b->width, b->height}, BROWN);
+            DrawRectangleLinesEx((Rectangle){x, b->y, b->width, b->height}, 2, DARKBROWN);
+        }
+    }
+}
+
 /* =============================
    PARALLAX
 ============================= */
-void DrawParallax(float cameraX)
+// Each layer repeats count times, starting one spacing left of the origin
+void DrawParallax(const LevelParallax *layers, int layerCount, float cameraX)
+{
+    for (int l = 0; l < layerCount; l++)
+    {
+        const LevelParallax *p = &layers[l];
+        Color color = { p->color[0], p->color[1], p->color[2], p->color[3] };
+        float baseX = -cameraX * p->factor - p->spacing;
+
+        for (int i = 0; i < (int)p->count; i++)
+        {
+            float x = baseX + i * p->spacing;
+            if (p->shape == LEVEL_PARALLAX_CIRCLE)
+                DrawCircle(x, p->y, p->size, color);
+            else
+                DrawTriangle(
+                        (Vector2){x+p->spacing*0.5f,p->y},
+                        (Vector2){x,p->y+p->size},
+                        (Vector2){x+p->spacing,p->y+p->size},
+                        color);
+        }
+    }
+}
+
+/* =============================
+   SIMULATION (ROLLBACK)
+============================= */
+// The player runs through the rollback layer even offline: the local input is
+// confirmed every tick, so there is nothing to correct until remote peers
+// feed Rollback_AddInput
+static Rollback rollback;
+static SimWorld simWorld;
+
+static void StartSimulation(Vector2 player, Vector2 facing, float velY, bool grounded, int jumpsUsed)
+{
+    SimState initial;
+    memset(&initial, 0, sizeof(initial));
+    initial.playerCount = 1;
+
+    SimPlayer *self = &initial.players[LOCAL_PLAYER];
+    Sim_InitPlayer(self, player.x, player.y);
+    self->facingX = facing.x;
+    self->velY = velY;
+    self->grounded = grounded;
+    self->jumpsUsed = jumpsUsed;
+
+    simWorld = (SimWorld){ &levelWorld, level.header->worldWidth };
+    Rollback_Init(&rollback, &initial, &simWorld);
+}
+
+/* =============================
+   SAVE STATE (PROCESS DEATH)
+============================= */
+static SaveState saveState; // refreshed every frame, persisted on SAVE_STATE / PAUSE
+
+static void CaptureSaveState(SaveState *s, Vector2 player, Vector2 facing, float velY,
+                             bool grounded, int jumpsUsed, float cameraX, const ChatState *chat)
+{
+    s->playerX = player.x;
+    s->playerY = player.y;
+    s->facingX = facing.x;
+    s->velY = velY;
+    s->grounded = grounded;
+    s->jumpsUsed = jumpsUsed;
+    s->cameraX = cameraX;
+
+    // Only the first SAVESTATE_MAX_BIRDS keep their place; the rest respawn from the level
+    s->birdCount = birdCount < SAVESTATE_MAX_BIRDS ? birdCount : SAVESTATE_MAX_BIRDS;
+    for (int i = 0; i < s->birdCount; i++)
+    {
+        s->birdX[i] = birds[i].x;
+        s->birdY[i] = birds[i].y;
+    }
+
+    s->chatLength = chat->length;
+    s->chatSentLength = chat->sentLength;
+    s->chatBubbleTimer = chat->bubbleTimer;
+    memcpy(s->chatText, chat->text, CHAT_MAX_TEXT);
+    memcpy(s->chatSentText, chat->sentText, CHAT_MAX_TEXT);
+}
+
+static void ApplySaveState(const SaveState *s, Vector2 *player, Vector2 *facing, float *velY,
+                           bool *grounded, int *jumpsUsed, float *cameraX, ChatState *chat)
+{
+    player->x = s->playerX;
+    player->y = s->playerY;
+    facing->x = s->facingX;
+    *velY = s->velY;
+    *grounded = s->grounded != 0;
+    *jumpsUsed = s->jumpsUsed;
+    *cameraX = s->cameraX;
+
+    for (int i = 0; i < birdCount && i < s->birdCount; i++)
+    {
+        birds[i].x = s->birdX[i];
+        birds[i].y = s->birdY[i];
+    }
+
+    // Keyboard stays closed on resume, only the text survives
+    chat->length = s->chatLength;
+    chat->sentLength = s->chatSentLength;
+    chat->bubbleTimer = s->chatBubbleTimer;
+    memcpy(chat->text, s->chatText, CHAT_MAX_TEXT);
+    memcpy(chat->sentText, s->chatSentText, CHAT_MAX_TEXT);
+    chat->text[CHAT_MAX_TEXT - 1] = '\0';
+    chat->sentText[CHAT_MAX_TEXT - 1] = '\0';
+}
+
+static const char *SaveStatePath(void)
+{
+#if defined(PLATFORM_ANDROID)
+    static char path[512];
+    struct android_app *app = GetAndroidApp();
+    if (!app || !app->activity || !app->activity->internalDataPath) return NULL;
+    snprintf(path, sizeof(path), "%s/%s", app->activity->internalDataPath, SAVESTATE_FILE_NAME);
+    return path;
+#else
+    return SAVESTATE_FILE_NAME;
+#endif
+}
+
+static void PersistSaveState(void)
+{
+    double start = GetTime();
+    const char *path = SaveStatePath();
+
+    SaveState_Seal(&saveState);
+    bool ok = path && SaveState_Write(&saveState, path);
+
+    TraceLog(ok ? LOG_INFO : LOG_WARNING, "SAVESTATE: %s %i bytes in %.1f us",
+             ok ? "Saved" : "Failed to save", (int)sizeof(SaveState), (GetTime() - start) * 1e6);
+}
+
+#if defined(PLATFORM_ANDROID)
+static SaveState instanceState;
+static bool hasInstanceState;
+
+// The glue frees app->savedState after APP_CMD_RESUME, which InitWindow
+// processes before main() could restore anything, so take a copy first
+static void CaptureInstanceState(void)
 {
-    float farX = -cameraX * 0.2f;
-    for (int i = -1; i < 12; i++)
-        DrawTriangle(
-                (Vector2){farX+i*400+200,240},
-                (Vector2){farX+i*400,400},
-                (Vector2){farX+i*400+400,400},
-                DARKPURPLE);
+    struct android_app *app = GetAndroidApp();
+    if (app && SaveState_Validate(app->savedState, app->savedStateSize))
+    {
+        memcpy(&instanceState, app->savedState, sizeof(SaveState));
+        hasInstanceState = true;
+    }
+}
+#endif
 
-    float midX = -cameraX * 0.4f;
-    for (int i = -1; i < 16; i++)
-        DrawCircle(midX+i*260,420,160,DARKBLUE);
+// Prefers the instance-state bundle handed back by the activity, falls back to the file
+static bool RestoreSaveState(SaveState *out)
+{
+    double start = GetTime();
+    const char *source = NULL;
+
+#if defined(PLATFORM_ANDROID)
+    if (hasInstanceState)
+    {
+        memcpy(out, &instanceState, sizeof(SaveState));
+        source = "instance state";
+    }
+#endif
+
+    if (!source)
+    {
+        const char *path = SaveStatePath();
+        if (path && SaveState_Read(out, path)) source = "file";
+    }
+
+    if (!source) return false;
+
+    TraceLog(LOG_INFO, "SAVESTATE: Restored from %s in %.1f us", source, (GetTime() - start) * 1e6);
+    return true;
 }
 
+/* =============================
+   GPU RESOURCES (LIFECYCLE)
+============================= */
+// Everything here is baked procedurally, so instead of holding it while the
+// activity sits in the background it is dropped and rebuilt on return, one
+// resource per frame so the first frame is not held up by the slow bakes.
+// Rebuild order is by need: nothing draws without the target, the ground
+// bake is the slowest.
+typedef enum GpuResource {
+    GPU_RESOURCE_TARGET = 0,
+    GPU_RESOURCE_SKY,
+    GPU_RESOURCE_SPRITES,
+    GPU_RESOURCE_GROUND,
+    GPU_RESOURCE_COUNT
+} GpuResource;
+
+static struct {
+    RenderTexture2D target;
+    Texture2D sky;
+    Texture2D ground;
+    bool loaded[GPU_RESOURCE_COUNT]; // Attempted; ids stay 0 if a load failed
+    float worldWidth;
+
+    // Visible only when resumed, focused and with a window
+    bool paused;
+    bool unfocused;
+    bool noWindow;
+
+    double resumeStart;  // Set when the app becomes visible again, 0 otherwise
+    bool firstFrameDone;
+} gpu;
+
+static bool IsAppVisible(void)
+{
+    return !gpu.paused && !gpu.unfocused && !gpu.noWindow;
+}
+
+static void ReleaseGpuResources(void)
+{
+    if (gpu.loaded[GPU_RESOURCE_TARGET] && gpu.target.id > 0) GpuMem_UnloadRenderTexture(gpu.target);
+    if (gpu.loaded[GPU_RESOURCE_SKY] && gpu.sky.id > 0) GpuMem_UnloadTexture(gpu.sky);
+    if (gpu.loaded[GPU_RESOURCE_GROUND] && gpu.ground.id > 0) GpuMem_UnloadTexture(gpu.ground);
+    if (gpu.loaded[GPU_RESOURCE_SPRITES]) Sprites_Unload();
+
+    gpu.target = (RenderTexture2D){ 0 };
+    gpu.sky = (Texture2D){ 0 };
+    gpu.ground = (Texture2D){ 0 };
+    memset(gpu.loaded, 0, sizeof(gpu.loaded));
+}
+
+// Loads the first missing resource. Returns true once nothing is missing.
+static bool RebuildNextGpuResource(void)
+{
+    for (int i = 0; i < GPU_RESOURCE_COUNT; i++)
+    {
+        if (gpu.loaded[i]) continue;
+
+        switch (i)
+        {
+            case GPU_RESOURCE_TARGET:
+                gpu.target = GpuMem_LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT, "target");
+                break;
+            case GPU_RESOURCE_SKY:
+                gpu.sky = BakeSkyTexture();
+                break;
+            case GPU_RESOURCE_SPRITES:
+                if (!Sprites_Init()) TraceLog(LOG_INFO, "SPRITES: No instancing support, drawing sprites one by one");
+                break;
+            case GPU_RESOURCE_GROUND:
+                gpu.ground = BakeGroundTexture(gpu.worldWidth);
+                break;
+            default:
+                break;
+        }
+        gpu.loaded[i] = true;
+        return i == GPU_RESOURCE_COUNT - 1;
+    }
+    return true;
+}
+
+#if defined(PLATFORM_ANDROID)
+static void (*RaylibOnAppCmd)(struct android_app *app, int32_t cmd) = NULL;
+
+static void UpdateVisibility(bool wasVisible)
+{
+    bool visible = IsAppVisible();
+    if (visible && !wasVisible)
+    {
+        gpu.resumeStart = GetTime();
+        gpu.firstFrameDone = false;
+    }
+    else if (!visible) gpu.resumeStart = 0.0;
+
+    // Out of sight for real (not just a dialog on top): free the GPU memory.
+    // This runs before raylib's handler, so on TERM_WINDOW the context is
+    // still current for the deletes.
+    if (gpu.paused || gpu.noWindow) ReleaseGpuResources();
+}
+
+// Runs on the game thread from inside raylib's event polling, so saveState is consistent
+static void OnAppCmd(struct android_app *app, int32_t cmd)
+{
+    bool wasVisible = IsAppVisible();
+
+    switch (cmd)
+    {
+        case APP_CMD_SAVE_STATE:
+            PersistSaveState();
+            // The glue hands this buffer to onSaveInstanceState, which takes ownership
+            app->savedState = malloc(sizeof(SaveState));
+            if (app->savedState)
+            {
+                memcpy(app->savedState, &saveState, sizeof(SaveState));
+                app->savedStateSize = sizeof(SaveState);
+            }
+            break;
+        case APP_CMD_PAUSE:
+            PersistSaveState();
+            Audio_SetPaused(true);
+            gpu.paused = true;
+            break;
+        case APP_CMD_RESUME:
+            Audio_SetPaused(false);
+            gpu.paused = false;
+            break;
+        case APP_CMD_LOST_FOCUS:
+            gpu.unfocused = true;
+            break;
+        case APP_CMD_GAINED_FOCUS:
+            gpu.unfocused = false;
+            break;
+        case APP_CMD_TERM_WINDOW:
+            gpu.noWindow = true;
+            break;
+        case APP_CMD_INIT_WINDOW:
+            gpu.noWindow = false;
+            break;
+        default:
+            break;
+    }
+    UpdateVisibility(wasVisible);
+
+    if (RaylibOnAppCmd) RaylibOnAppCmd(app, cmd);
+}
+#endif
+
 /* =============================
    ANDROID ENTRY POINT
 ============================= */
 int main(void)
 {
+#if defined(PLATFORM_ANDROID)
+    CaptureInstanceState();
+#endif
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "U-MG Android (Portrait)");
     SetTargetFPS(60);
     SetWindowMinSize(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-    RenderTexture2D target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+#if defined(PLATFORM_ANDROID)
+    struct android_app *app = GetAndroidApp();
+    RaylibOnAppCmd = app->onAppCmd;
+    app->onAppCmd = OnAppCmd;
+#endif
 
-    /* === ADDED: PROCEDURAL SKY TEXTURE (cached) === */
-    RenderTexture2D skyTex = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
-    BeginTextureMode(skyTex);
-    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    if (!LoadLevel())
     {
-        float ty = (float)y / SCREEN_HEIGHT;
-        Color c = ColorLerp(SKYBLUE, (Color){30,50,120,255}, ty);
-        DrawRectangle(0, y, SCREEN_WIDTH, 1, c);
+        TraceLog(LOG_ERROR, "LEVEL: Failed to load the level");
+        CloseWindow();
+        return 1;
     }
-    EndTextureMode();
+    const LevelHeader *layout = level.header;
 
-    /* === ADDED: PROCEDURAL GROUND TEXTURE (cached) === */
-    RenderTexture2D groundTex = LoadRenderTexture(WORLD_WIDTH, 200);
-    BeginTextureMode(groundTex);
-    ClearBackground(DARKBROWN);
-    for (int x = 0; x < WORLD_WIDTH; x += 4)
-    {
-        float n = sinf(x * 0.03f) * 6 + cosf(x * 0.11f) * 3;
-        DrawRectangle(x, 40 + n, 4, 160, Fade(BROWN, 0.75f));
-    }
-    for (int i = 0; i < 400; i++)
-        DrawCircle(GetRandomValue(0, WORLD_WIDTH),
-                   GetRandomValue(80, 180),
-                   GetRandomValue(2, 4),
-                   Fade(DARKGRAY, 0.35f));
-    EndTextureMode();
+    if (!Audio_Init()) TraceLog(LOG_WARNING, "AUDIO: Failed to start output, running silent");
+    if (!Jobs_Init(0, JOBS_AFFINITY_BIG))
+        TraceLog(LOG_WARNING, "JOBS: Not every worker started on the big cores, running with %i", Jobs_WorkerCount());
 
-    Vector2 player = {200, GROUND_Y};
+    /* === ADDED: PROCEDURAL SKY AND GROUND TEXTURES (cached, see GPU RESOURCES) === */
+    gpu.worldWidth = layout->worldWidth;
+    while (!RebuildNextGpuResource()) {}
+
+    Vector2 player = {layout->spawnX, layout->spawnY};
     Vector2 facing = {1,0};
     float speed = 0, velY = 0;
     bool grounded = true;
     int jumpsUsed = 0;
     float cameraX = 0;
 
-    float transitionCenter = WORLD_WIDTH * 0.5f;
-    float transitionWidth  = 600.0f;
+    float transitionCenter = layout->transitionCenter;
+    float transitionWidth  = layout->transitionWidth;
 
     float sunX = SCREEN_WIDTH - 80;
     float sunStartY = 80, sunEndY = SCREEN_HEIGHT + 120, sunRadius = 220;
@@ -345,12 +955,31 @@ int main(void)
     ChatState chat;
     Chat_Init(&chat);
 
+    if (RestoreSaveState(&saveState))
+        ApplySaveState(&saveState, &player, &facing, &velY, &grounded, &jumpsUsed, &cameraX, &chat);
+
+    StartSimulation(player, facing, velY, grounded, jumpsUsed);
+    Net_Init(NET_SERVER_HOST, NET_SERVER_PORT);
+
     float joyHapticCooldown = 0.0f;
+    static char gpuReport[1024];
+    float footstepTimer = 0.0f;
 
     while (!WindowShouldClose())
     {
+        if (!IsAppVisible())
+        {
+            // Nothing to draw to. raylib's polling sleeps while unfocused;
+            // the wait covers being paused with focus (multi-window).
+            PollInputEvents();
+            WaitTime(0.05);
+            continue;
+        }
+        bool rebuilding = !RebuildNextGpuResource();
+
         float time = GetTime();
         speed = 0;
+        SimInput input = {0, 0};
         float dt = GetFrameTime();
         Chat_Update(&chat, dt);
 
@@ -388,10 +1017,7 @@ int main(void)
                 joy.delta = Vector2Scale(d, 1.0f / joy.radius);
 
                 speed = fabsf(joy.delta.x);
-                player.x += joy.delta.x * 5.5f;
-
-                if (fabsf(joy.delta.x) > 0.01f)
-                    facing.x = joy.delta.x > 0 ? 1.0f : -1.0f;
+                input.moveX = (int8_t)(joy.delta.x * 127.0f);
 
                 if (speed > 0.1f && joyHapticCooldown <= 0.0f)
                 {
@@ -405,13 +1031,11 @@ int main(void)
             /* === JUMP BUTTON === */
             if (jumpFinger == -1 &&
                 touchId != joy.finger &&
-                jumpsUsed < MAX_JUMPS &&
+                jumpsUsed < SIM_MAX_JUMPS &&
                 CheckCollisionPointCircle(p, jumpBtn, jumpRadius))
             {
                 jumpFinger = touchId;
-                velY = JUMP_VELOCITY;
-                grounded = false;
-                jumpsUsed++;
+                input.buttons |= SIM_BUTTON_JUMP;
 
 #if defined(PLATFORM_ANDROID)
                 TriggerHapticFeedback(30);
@@ -459,55 +1083,105 @@ int main(void)
         }
 
 
-        velY += GRAVITY;
-        player.y += velY;
+        Rollback_AddInput(&rollback, LOCAL_PLAYER, rollback.current.tick, input);
+        Rollback_Advance(&rollback);
+
+        const SimPlayer *self = &rollback.current.players[LOCAL_PLAYER];
+        player = (Vector2){ self->x, self->y };
+        facing.x = self->facingX;
+        velY = self->velY;
+        grounded = self->grounded != 0;
+        jumpsUsed = self->jumpsUsed;
+
+        // Second jump rings a little higher
+        if (self->events & SIM_EVENT_JUMP)
+            Audio_Play(AUDIO_SOUND_JUMP, 0.7f, 1.0f + 0.15f * (jumpsUsed - 1));
+
+        if (grounded && speed > 0.1f)
+        {
+            footstepTimer -= dt * speed;
+            if (footstepTimer <= 0.0f)
+            {
+                Audio_Play(AUDIO_SOUND_FOOTSTEP, 0.5f, 0.9f + 0.2f * GetRandomValue(0, 100) / 100.0f);
+                footstepTimer = FOOTSTEP_INTERVAL;
+            }
+        }
+        else footstepTimer = 0.0f;
 
-        if (player.y >= GROUND_Y)
+        if (chat.pendingSend)
         {
-            player.y = GROUND_Y;
-            velY = 0;
-            grounded = true;
-            jumpsUsed = 0;
+            Net_SendChat(chat.sentText);
+            chat.pendingSend = false;
         }
+        Net_Update(dt, player.x, player.y, facing.x, grounded);
 
-        player.x = Clamp(player.x, 0, WORLD_WIDTH);
-        cameraX = Clamp(player.x - SCREEN_WIDTH*0.4f, 0, WORLD_WIDTH-SCREEN_WIDTH);
+        cameraX = Clamp(player.x - SCREEN_WIDTH*0.4f, 0, layout->worldWidth-SCREEN_WIDTH);
 
         float t = Clamp(
                 (player.x - (transitionCenter-transitionWidth*0.5f))/transitionWidth,
                 0,1);
 
-        float ambient = Lerp(DAY_AMBIENT, NIGHT_AMBIENT, t);
+        float ambient = Lerp(layout->dayAmbient, layout->nightAmbient, t);
 
         UpdateBirds(time);
 
-        BeginTextureMode(target);
+        CaptureSaveState(&saveState, player, facing, velY, grounded, jumpsUsed, cameraX, &chat);
+
+        // Without a target (refused by the GPU budget) the scene goes straight
+        // to the screen, scaled the same way the target would have been
+        bool offscreen = gpu.target.id > 0;
+        if (offscreen) BeginTextureMode(gpu.target);
+        else
+        {
+            BeginDrawing();
+            ClearBackground(BLACK);
+            rlPushMatrix();
+            rlScalef((float)GetScreenWidth()/SCREEN_WIDTH, (float)GetScreenHeight()/SCREEN_HEIGHT, 1.0f);
+        }
 
         /* === ADDED: draw procedural sky BEFORE original clear === */
-        DrawTexture(skyTex.texture, 0, 0, WHITE);
+        if (gpu.sky.id > 0)
+            DrawTexturePro(gpu.sky, (Rectangle){0,0,1,SCREEN_HEIGHT},
+                           (Rectangle){0,0,SCREEN_WIDTH,SCREEN_HEIGHT}, (Vector2){0,0}, 0, WHITE);
         ClearBackground(Fade(SKYBLUE,0.35f));
 
-        DrawParallax(cameraX);
+        DrawParallax(level.parallax, level.parallaxCount, cameraX);
         DrawBirds(1.0f - t, time);
+        DrawLevel(cameraX);
 
         /* === ADDED: procedural ground under original ground === */
-        DrawTextureRec(
-                groundTex.texture,
-                (Rectangle){cameraX,0,SCREEN_WIDTH,200},
-                (Vector2){0,GROUND_Y+24},
-                WHITE
-        );
+        if (gpu.ground.id > 0)
+            DrawTextureRec(
+                    gpu.ground,
+                    (Rectangle){cameraX,0,SCREEN_WIDTH,GROUND_TEX_HEIGHT},
+                    (Vector2){0,layout->groundY+24},
+                    WHITE
+            );
+
+        DrawRectangle(-cameraX, layout->groundY+24, layout->worldWidth, 200, Fade(DARKBROWN,0.4f));
+        int peerCount;
+        const NetPeer *peers = Net_Peers(&peerCount);
+        for (int i = 0; i < peerCount; i++)
+        {
+            const NetPeer *peer = &peers[i];
+            if (peer->x < cameraX - 64 || peer->x > cameraX + SCREEN_WIDTH + 64) continue;
+
+            float peerSpeed = fabsf(peer->targetX - peer->x) > 0.5f ? 1.0f : 0.0f;
+            DrawPlayer((Vector2){peer->x-cameraX,peer->y}, (Vector2){peer->facing,0}, peerSpeed, time);
+        }
 
-        DrawRectangle(-cameraX, GROUND_Y+24, WORLD_WIDTH, 200, Fade(DARKBROWN,0.4f));
         DrawPlayer((Vector2){player.x-cameraX,player.y}, facing, speed, time);
 
+        for (int i = 0; i < peerCount; i++)
+            if (peers[i].chatTimer > 0.0f)
+                Chat_DrawBubbleText(peers[i].chat, (Vector2){peers[i].x,peers[i].y}, cameraX);
         Chat_DrawBubble(&chat, player, cameraX);
 
         BeginBlendMode(BLEND_MULTIPLIED);
         DrawRectangle(0,0,SCREEN_WIDTH,SCREEN_HEIGHT,Fade(BLACK,ambient));
         EndBlendMode();
 
-        DrawStars(t, time);
+        DrawStars(level.stars, level.starCount, t, time);
 
         BeginBlendMode(BLEND_ADDITIVE);
         DrawCircleGradient(sunX, Lerp(sunStartY,sunEndY,t),
@@ -522,7 +1196,7 @@ int main(void)
         DrawCircleV(
                 jumpBtn,
                 drawRadius,
-                jumpsUsed < MAX_JUMPS ? Fade(GREEN,0.6f) : Fade(GRAY,0.4f)
+                jumpsUsed < SIM_MAX_JUMPS ? Fade(GREEN,0.6f) : Fade(GRAY,0.4f)
         );
 
         DrawOutlinedText(
@@ -548,23 +1222,77 @@ int main(void)
                 GRAY
         );
 
-        EndTextureMode();
+        if (offscreen)
+        {
+            EndTextureMode();
 
-        BeginDrawing();
-        ClearBackground(BLACK);
+            BeginDrawing();
+            ClearBackground(BLACK);
 
-        Rectangle src = {0,0,SCREEN_WIDTH,-SCREEN_HEIGHT};
-        Rectangle dst = {0,0,GetScreenWidth(),GetScreenHeight()};
-        DrawTexturePro(target.texture, src, dst, (Vector2){0,0}, 0, WHITE);
+            Rectangle src = {0,0,SCREEN_WIDTH,-SCREEN_HEIGHT};
+            Rectangle dst = {0,0,GetScreenWidth(),GetScreenHeight()};
+            DrawTexturePro(gpu.target.texture, src, dst, (Vector2){0,0}, 0, WHITE);
+        }
+        else rlPopMatrix();
 
         Chat_DrawUI(&chat);
 
+        if (GpuMem_Changed())
+        {
+            GpuMem_Report(gpuReport, sizeof(gpuReport));
+            TraceLog(LOG_INFO, "GPUMEM:\n%s", gpuReport);
+        }
+#if DEBUG_HUD
+        GpuMem_Report(gpuReport, sizeof(gpuReport));
+        DrawText(gpuReport, 8, 8, 10, RAYWHITE);
+#endif
+
         EndDrawing();
+
+        if (gpu.resumeStart > 0.0)
+        {
+            if (!gpu.firstFrameDone)
+            {
+                TraceLog(LOG_INFO, "LIFECYCLE: First frame %.1f ms after resume",
+                         (GetTime() - gpu.resumeStart) * 1000.0);
+                gpu.firstFrameDone = true;
+            }
+            if (!rebuilding)
+            {
+                TraceLog(LOG_INFO, "LIFECYCLE: GPU resources rebuilt %.1f ms after resume",
+                         (GetTime() - gpu.resumeStart) * 1000.0);
+                gpu.resumeStart = 0.0;
+            }
+        }
     }
 
-    UnloadRenderTexture(skyTex);
-    UnloadRenderTexture(groundTex);
-    UnloadRenderTexture(target);
+    PersistSaveState();
+
+    AudioStats audioStats;
+    Audio_GetStats(&audioStats);
+    TraceLog(LOG_INFO, "AUDIO: %i callbacks, mix max %i us, %i deadline misses, %i dropped commands",
+             (int)audioStats.callbacks, (int)audioStats.maxMixMicros,
+             (int)audioStats.deadlineMisses, (int)audioStats.droppedCommands);
+    Audio_Shutdown();
+    Jobs_Shutdown();
+
+    NetStats netStats;
+    Net_GetStats(&netStats);
+    if (netStats.packetsOut > 0)
+        TraceLog(LOG_INFO, "NET: %u packets in (%u bytes), %u out (%u bytes), last rtt %u ms",
+                 netStats.packetsIn, netStats.bytesIn, netStats.packetsOut, netStats.bytesOut, netStats.rttMillis);
+    Net_Shutdown();
+
+    const RollbackStats *rollbackStats = &rollback.stats;
+    TraceLog(LOG_INFO, "ROLLBACK: %i ticks, %i rollbacks (max depth %i, max resim %i us), %i stalls",
+             (int)rollbackStats->ticks, (int)rollbackStats->rollbacks, rollbackStats->maxDepth,
+             (int)rollbackStats->maxResimMicros, (int)rollbackStats->stalls);
+
+    FreeBirds();
+    free(levelVisible);
+    Collision_Free(&levelWorld);
+    Level_Close(&level);
+    ReleaseGpuResources();
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,313 @@
+#define _POSIX_C_SOURCE 200809L
+#include "net.h"
+#include "raylib.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NET_SMOOTHING 12.0f // Per second; peers close most of a 50 ms gap in one tick
+
+/* =============================
+   STATE (game thread only)
+============================= */
+static int sock = -1;
+static int localId = -1;
+static float helloTimer;
+static float sendTimer;
+static float silence; // Seconds since the server was last heard from
+static NetPeer peers[NET_MAX_PEERS];
+static int peerCount;
+static NetStats stats;
+
+static uint32_t NowMillis(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000u + ts.tv_nsec / 1000000);
+}
+
+static void Send(const NetWriter *w)
+{
+    if (sock < 0 || w->overflow) return;
+    if (send(sock, w->data, (size_t)w->size, 0) == w->size)
+    {
+        stats.packetsOut++;
+        stats.bytesOut += (uint32_t)w->size;
+    }
+}
+
+static void SendEmpty(NetMessage type)
+{
+    uint8_t buffer[NET_HEADER_SIZE];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, type);
+    Send(&w);
+}
+
+/* =============================
+   PEERS
+============================= */
+static void RemovePeer(int index)
+{
+    peers[index] = peers[--peerCount];
+}
+
+static NetPeer *FindPeer(uint16_t id, bool create)
+{
+    for (int i = 0; i < peerCount; i++)
+        if (peers[i].id == id) return &peers[i];
+    if (!create) return NULL;
+
+    if (peerCount == NET_MAX_PEERS)
+    {
+        // Full: whoever has gone longest without a snapshot entry (a leave
+        // notice lost or still queued on the server) makes way for a peer the
+        // server is sending now. Peers from this very snapshot are never evicted.
+        int stalest = 0;
+        for (int i = 1; i < peerCount; i++)
+            if (peers[i].lastSeen > peers[stalest].lastSeen) stalest = i;
+        if (peers[stalest].lastSeen <= 0.0f) return NULL;
+        RemovePeer(stalest);
+    }
+
+    NetPeer *peer = &peers[peerCount++];
+    memset(peer, 0, sizeof(*peer));
+    peer->id = id;
+    return peer;
+}
+
+/* =============================
+   RECEIVE
+============================= */
+static void HandleSnapshot(NetReader *r)
+{
+    Net_ReadU32(r); // serverTick
+    uint32_t echo = Net_ReadU32(r);
+    int count = Net_ReadU16(r);
+    if (r->overflow) return;
+    if (echo != 0) stats.rttMillis = NowMillis() - echo;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint16_t id = Net_ReadU16(r);
+        float x = Net_ReadF32(r);
+        float y = Net_ReadF32(r);
+        int8_t facing = (int8_t)Net_ReadU8(r);
+        uint8_t flags = Net_ReadU8(r);
+        if (r->overflow) return;
+        if (id == localId) continue;
+
+        if (flags & NET_FLAG_LEFT)
+        {
+            NetPeer *gone = FindPeer(id, false);
+            if (gone) RemovePeer((int)(gone - peers));
+            continue;
+        }
+
+        NetPeer *peer = FindPeer(id, true);
+        if (!peer) continue;
+        if (!peer->active)
+        {
+            // Appear in place instead of sliding in from the origin
+            peer->x = x;
+            peer->y = y;
+            peer->active = true;
+        }
+        peer->targetX = x;
+        peer->targetY = y;
+        peer->facing = facing;
+        peer->flags = flags;
+        peer->lastSeen = 0.0f;
+    }
+}
+
+static void HandleChatRelay(NetReader *r)
+{
+    uint16_t id = Net_ReadU16(r);
+    Net_ReadU32(r); // clientTime
+    int length = Net_ReadU8(r);
+    if (r->overflow || length > NET_MAX_CHAT || id == localId) return;
+
+    NetPeer *peer = FindPeer(id, false);
+    if (!peer) return;
+    Net_ReadBytes(r, peer->chat, length);
+    if (r->overflow) return;
+    peer->chat[length] = '\0';
+    peer->chatTimer = NET_CHAT_BUBBLE_TIME;
+}
+
+static void Receive(void)
+{
+    uint8_t buffer[NET_MAX_PACKET];
+    for (;;)
+    {
+        ssize_t size = recv(sock, buffer, sizeof(buffer), 0);
+        if (size < 0) break;
+        silence = 0.0f;
+        stats.packetsIn++;
+        stats.bytesIn += (uint32_t)size;
+
+        NetReader r = Net_Reader(buffer, (int)size);
+        switch (Net_ReadHeader(&r))
+        {
+            case NET_MSG_WELCOME:
+            {
+                int id = Net_ReadU16(&r);
+                if (r.overflow) break;
+                if (localId < 0) TraceLog(LOG_INFO, "NET: Joined as player %i", id);
+                localId = id;
+                break;
+            }
+            case NET_MSG_SNAPSHOT:   HandleSnapshot(&r); break;
+            case NET_MSG_CHAT_RELAY: HandleChatRelay(&r); break;
+            default: break;
+        }
+    }
+}
+
+/* =============================
+   API
+============================= */
+bool Net_Init(const char *host, int port)
+{
+    if (!host || !host[0]) return false;
+
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &server.sin_addr) != 1)
+    {
+        TraceLog(LOG_WARNING, "NET: %s is not an IPv4 address", host);
+        return false;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+    // connect() filters out datagrams from anyone but the server
+    if (fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK) != 0 ||
+        connect(sock, (struct sockaddr *)&server, sizeof(server)) != 0)
+    {
+        TraceLog(LOG_WARNING, "NET: Failed to open socket (%s)", strerror(errno));
+        close(sock);
+        sock = -1;
+        return false;
+    }
+
+    localId = -1;
+    peerCount = 0;
+    helloTimer = 0.0f;
+    sendTimer = 0.0f;
+    silence = 0.0f;
+    memset(&stats, 0, sizeof(stats));
+    TraceLog(LOG_INFO, "NET: Connecting to %s:%i", host, port);
+    return true;
+}
+
+void Net_Shutdown(void)
+{
+    if (sock < 0) return;
+    if (localId >= 0) SendEmpty(NET_MSG_BYE);
+    close(sock);
+    sock = -1;
+    localId = -1;
+    peerCount = 0;
+}
+
+void Net_Update(float dt, float x, float y, float facingX, bool grounded)
+{
+    if (sock < 0) return;
+
+    // The server forgets clients it has not heard from, e.g. across a long
+    // pause in the background, and ignores them until they say HELLO again.
+    // Checked before draining so packets queued up during the pause do not
+    // hide the gap.
+    silence += dt;
+    if (localId >= 0 && silence * 1000.0f > NET_CLIENT_TIMEOUT_MS)
+    {
+        TraceLog(LOG_INFO, "NET: Lost the server, rejoining");
+        localId = -1;
+        peerCount = 0;
+        helloTimer = 0.0f;
+    }
+    Receive();
+
+    for (int i = peerCount - 1; i >= 0; i--)
+    {
+        NetPeer *peer = &peers[i];
+        peer->lastSeen += dt;
+        if (peer->lastSeen > NET_PEER_TIMEOUT)
+        {
+            RemovePeer(i);
+            continue;
+        }
+        float blend = 1.0f - expf(-NET_SMOOTHING * dt);
+        peer->x += (peer->targetX - peer->x) * blend;
+        peer->y += (peer->targetY - peer->y) * blend;
+        if (peer->chatTimer > 0.0f) peer->chatTimer -= dt;
+    }
+
+    if (localId < 0)
+    {
+        helloTimer -= dt;
+        if (helloTimer <= 0.0f)
+        {
+            SendEmpty(NET_MSG_HELLO);
+            helloTimer = NET_HELLO_INTERVAL;
+        }
+        return;
+    }
+
+    sendTimer -= dt;
+    if (sendTimer > 0.0f) return;
+    sendTimer += 1.0f / NET_TICK_RATE;
+    if (sendTimer < 0.0f) sendTimer = 0.0f; // Do not burst after a stall
+
+    uint8_t buffer[32];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, NET_MSG_STATE);
+    Net_WriteU32(&w, NowMillis());
+    Net_WriteF32(&w, x);
+    Net_WriteF32(&w, y);
+    Net_WriteU8(&w, (uint8_t)(int8_t)(facingX < 0.0f ? -1 : 1));
+    Net_WriteU8(&w, grounded ? NET_FLAG_GROUNDED : 0);
+    Send(&w);
+}
+
+void Net_SendChat(const char *text)
+{
+    if (sock < 0 || localId < 0) return;
+
+    int length = (int)strlen(text);
+    if (length > NET_MAX_CHAT) length = NET_MAX_CHAT;
+
+    uint8_t buffer[NET_HEADER_SIZE + 5 + NET_MAX_CHAT];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, NET_MSG_CHAT);
+    Net_WriteU32(&w, NowMillis());
+    Net_WriteU8(&w, (uint8_t)length);
+    Net_WriteBytes(&w, text, length);
+    Send(&w);
+}
+
+bool Net_Connected(void)
+{
+    return sock >= 0 && localId >= 0;
+}
+
+const NetPeer *Net_Peers(int *count)
+{
+    *count = peerCount;
+    return peers;
+}
+
+void Net_GetStats(NetStats *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,47 @@
+#ifndef NET_H
+#define NET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "netproto.h"
+
+#define NET_MAX_PEERS        64 // The server never puts more than this in one view
+#define NET_HELLO_INTERVAL   0.5f // Seconds between HELLOs until WELCOMEd
+#define NET_PEER_TIMEOUT     2.0f // Seconds without a snapshot entry before a peer is hidden
+#define NET_CHAT_BUBBLE_TIME 5.0f
+
+// Another player as last reported by the relay server
+typedef struct NetPeer {
+    bool active;
+    uint16_t id;
+    float x, y;        // Smoothed toward targetX/targetY between snapshots
+    float targetX, targetY;
+    int8_t facing;
+    uint8_t flags;
+    float lastSeen;    // Seconds since the last snapshot that carried this peer
+    char chat[NET_MAX_CHAT + 1];
+    float chatTimer;
+} NetPeer;
+
+typedef struct NetStats {
+    uint32_t packetsIn, packetsOut;
+    uint32_t bytesIn, bytesOut;
+    uint32_t rttMillis; // Last STATE -> SNAPSHOT echo, includes the server tick wait
+} NetStats;
+
+// Opens a non-blocking UDP socket to host (an IPv4 literal) and starts saying
+// HELLO. Returns false and stays offline on any failure.
+bool Net_Init(const char *host, int port);
+void Net_Shutdown(void);
+
+// Game thread, once per frame. Drains every waiting datagram, then sends the
+// local player's state at NET_TICK_RATE.
+void Net_Update(float dt, float x, float y, float facingX, bool grounded);
+
+void Net_SendChat(const char *text);
+
+bool Net_Connected(void);
+const NetPeer *Net_Peers(int *count);
+void Net_GetStats(NetStats *stats);
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef NETPROTO_H
+#define NETPROTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Wire protocol shared by the game (net.c) and the relay server (server/).
+// UDP datagrams, every field little-endian, written byte by byte so the
+// layout never depends on struct packing.
+
+#define NET_DEFAULT_PORT       7777
+#define NET_VERSION            2
+#define NET_MAX_PACKET         1200 // Stays under common path MTUs
+#define NET_TICK_RATE          20   // Server broadcasts per second
+#define NET_CLIENT_TIMEOUT_MS  5000
+#define NET_MAX_CHAT           127
+
+typedef enum NetMessage {
+    NET_MSG_HELLO = 1,  // c->s: -
+    NET_MSG_WELCOME,    // s->c: u16 id, u16 tickRate
+    NET_MSG_STATE,      // c->s: u32 clientTime, f32 x, f32 y, i8 facing, u8 flags
+    NET_MSG_CHAT,       // c->s: u32 clientTime, u8 length, text
+    NET_MSG_SNAPSHOT,   // s->c: u32 serverTick, u32 echoTime, u16 count, count * entity (nearby players only)
+    NET_MSG_CHAT_RELAY, // s->c: u16 id, u32 clientTime, u8 length, text
+    NET_MSG_BYE         // c->s: -
+} NetMessage;
+
+#define NET_HEADER_SIZE          2  // u8 type, u8 version
+#define NET_SNAPSHOT_HEADER_SIZE (NET_HEADER_SIZE + 8)
+#define NET_ENTITY_SIZE          12 // u16 id, f32 x, f32 y, i8 facing, u8 flags
+
+typedef enum NetEntityFlags {
+    NET_FLAG_GROUNDED = 1 << 0,
+    NET_FLAG_LEFT     = 1 << 7  // Server only: entity left the area of interest, x/y are stale
+} NetEntityFlags;
+
+/* =============================
+   BYTE WRITER / READER
+============================= */
+typedef struct NetWriter {
+    uint8_t *data;
+    int size;
+    int capacity;
+    bool overflow;
+} NetWriter;
+
+typedef struct NetReader {
+    const uint8_t *data;
+    int size;
+    int offset;
+    bool overflow;
+} NetReader;
+
+static inline NetWriter Net_Writer(uint8_t *data, int capacity)
+{
+    return (NetWriter){ data, 0, capacity, false };
+}
+
+static inline NetReader Net_Reader(const uint8_t *data, int size)
+{
+    return (NetReader){ data, size, 0, false };
+}
+
+static inline void Net_WriteU8(NetWriter *w, uint8_t v)
+{
+    if (w->size + 1 > w->capacity) { w->overflow = true; return; }
+    w->data[w->size++] = v;
+}
+
+static inline void Net_WriteU16(NetWriter *w, uint16_t v)
+{
+    if (w->size + 2 > w->capacity) { w->overflow = true; return; }
+    w->data[w->size++] = (uint8_t)v;
+    w->data[w->size++] = (uint8_t)(v >> 8);
+}
+
+static inline void Net_WriteU32(NetWriter *w, uint32_t v)
+{
+    if (w->size + 4 > w->capacity) { w->overflow = true; return; }
+    for (int i = 0; i < 4; i++) w->data[w->size++] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void Net_WriteF32(NetWriter *w, float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    Net_WriteU32(w, bits);
+}
+
+static inline void Net_WriteBytes(NetWriter *w, const void *bytes, int count)
+{
+    if (w->size + count > w->capacity) { w->overflow = true; return; }
+    memcpy(w->data + w->size, bytes, (size_t)count);
+    w->size += count;
+}
+
+static inline void Net_WriteHeader(NetWriter *w, NetMessage type)
+{
+    Net_WriteU8(w, (uint8_t)type);
+    Net_WriteU8(w, NET_VERSION);
+}
+
+static inline uint8_t Net_ReadU8(NetReader *r)
+{
+    if (r->offset + 1 > r->size) { r->overflow = true; return 0; }
+    return r->data[r->offset++];
+}
+
+static inline uint16_t Net_ReadU16(NetReader *r)
+{
+    if (r->offset + 2 > r->size) { r->overflow = true; return 0; }
+    uint16_t v = (uint16_t)(r->data[r->offset] | (r->data[r->offset + 1] << 8));
+    r->offset += 2;
+    return v;
+}
+
+static inline uint32_t Net_ReadU32(NetReader *r)
+{
+    if (r->offset + 4 > r->size) { r->overflow = true; return 0; }
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)r->data[r->offset++] << (8 * i);
+    return v;
+}
+
+static inline float Net_ReadF32(NetReader *r)
+{
+    uint32_t bits = Net_ReadU32(r);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static inline void Net_ReadBytes(NetReader *r, void *bytes, int count)
+{
+    if (r->offset + count > r->size) { r->overflow = true; return; }
+    memcpy(bytes, r->data + r->offset, (size_t)count);
+    r->offset += count;
+}
+
+// Returns the message type, or 0 for a foreign or outdated packet
+static inline int Net_ReadHeader(NetReader *r)
+{
+    uint8_t type = Net_ReadU8(r);
+    uint8_t version = Net_ReadU8(r);
+    return (r->overflow || version != NET_VERSION) ? 0 : type;
+}
+
+#endif
@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE 200809L
+#include "rollback.h"
+#include <string.h>
+#include <time.h>
+
+static uint64_t NowMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static bool SameInput(SimInput a, SimInput b)
+{
+    return a.moveX == b.moveX && a.buttons == b.buttons;
+}
+
+static bool IsConfirmed(const Rollback *rb, int player, uint32_t tick)
+{
+    return rb->confirmedFor[tick % ROLLBACK_RING_SIZE][player] == tick + 1;
+}
+
+// Held stick, released buttons: a jump is an edge and must not repeat
+static SimInput Predict(const Rollback *rb, int player)
+{
+    return (SimInput){ rb->lastConfirmed[player].moveX, 0 };
+}
+
+static void MarkRollback(Rollback *rb, uint32_t tick)
+{
+    if (tick < rb->rollbackTick) rb->rollbackTick = tick;
+}
+
+void Rollback_Init(Rollback *rb, const SimState *initial, const SimWorld *world)
+{
+    memset(rb, 0, sizeof(Rollback));
+    rb->current = *initial;
+    rb->world = *world;
+    rb->rollbackTick = initial->tick;
+    for (int p = 0; p < SIM_MAX_PLAYERS; p++) rb->confirmedTick[p] = initial->tick;
+}
+
+uint32_t Rollback_ConfirmedTick(const Rollback *rb)
+{
+    uint32_t oldest = rb->current.tick;
+    for (int p = 0; p < rb->current.playerCount; p++)
+        if (rb->confirmedTick[p] < oldest) oldest = rb->confirmedTick[p];
+    return oldest;
+}
+
+bool Rollback_AddInput(Rollback *rb, int player, uint32_t tick, SimInput input)
+{
+    if (player < 0 || player >= rb->current.playerCount) return false;
+    if (tick < rb->confirmedTick[player] || IsConfirmed(rb, player, tick)) return true; // Duplicate
+
+    // The slot must not still hold a tick we may resimulate
+    if (tick >= Rollback_ConfirmedTick(rb) + ROLLBACK_RING_SIZE) return false;
+
+    int slot = tick % ROLLBACK_RING_SIZE;
+    if (tick < rb->current.tick && !SameInput(rb->inputs[slot][player], input)) MarkRollback(rb, tick);
+    rb->inputs[slot][player] = input;
+    rb->confirmedFor[slot][player] = tick + 1;
+
+    uint32_t confirmed = rb->confirmedTick[player];
+    if (tick != confirmed) return true;
+
+    // Inputs can arrive out of order; extend the confirmed run as far as it goes
+    while (IsConfirmed(rb, player, confirmed))
+    {
+        rb->lastConfirmed[player] = rb->inputs[confirmed % ROLLBACK_RING_SIZE][player];
+        confirmed++;
+    }
+    rb->confirmedTick[player] = confirmed;
+
+    // Ticks already run on a stale guess get the new prediction
+    SimInput predicted = Predict(rb, player);
+    for (uint32_t t = confirmed; t < rb->current.tick; t++)
+    {
+        int s = t % ROLLBACK_RING_SIZE;
+        if (IsConfirmed(rb, player, t) || SameInput(rb->inputs[s][player], predicted)) continue;
+        rb->inputs[s][player] = predicted;
+        MarkRollback(rb, t);
+    }
+    return true;
+}
+
+bool Rollback_Advance(Rollback *rb)
+{
+    uint32_t now = rb->current.tick;
+
+    if (now - Rollback_ConfirmedTick(rb) >= ROLLBACK_MAX_PREDICTION)
+    {
+        rb->stats.stalls++;
+        return false;
+    }
+
+    if (rb->rollbackTick < now)
+    {
+        uint64_t start = NowMicros();
+        int depth = (int)(now - rb->rollbackTick);
+
+        rb->current = rb->states[rb->rollbackTick % ROLLBACK_RING_SIZE];
+        while (rb->current.tick < now)
+        {
+            int slot = rb->current.tick % ROLLBACK_RING_SIZE;
+            rb->states[slot] = rb->current;
+            Sim_Step(&rb->current, rb->inputs[slot], &rb->world);
+        }
+
+        uint32_t micros = (uint32_t)(NowMicros() - start);
+        rb->stats.rollbacks++;
+        rb->stats.resimTicks += (uint32_t)depth;
+        rb->stats.lastDepth = depth;
+        if (depth > rb->stats.maxDepth) rb->stats.maxDepth = depth;
+        rb->stats.lastResimMicros = micros;
+        if (micros > rb->stats.maxResimMicros) rb->stats.maxResimMicros = micros;
+        rb->stats.totalResimMicros += micros;
+    }
+
+    int slot = now % ROLLBACK_RING_SIZE;
+    for (int p = 0; p < rb->current.playerCount; p++)
+        if (!IsConfirmed(rb, p, now)) rb->inputs[slot][p] = Predict(rb, p);
+
+    rb->states[slot] = rb->current;
+    Sim_Step(&rb->current, rb->inputs[slot], &rb->world);
+    rb->rollbackTick = rb->current.tick;
+    rb->stats.ticks++;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sim.h"
+
+#define ROLLBACK_RING_SIZE      32 // Snapshots kept, must exceed the prediction window
+#define ROLLBACK_MAX_PREDICTION 12 // Ticks we may run ahead of the slowest peer's confirmed input
+
+typedef struct RollbackStats {
+    uint32_t ticks;
+    uint32_t rollbacks;
+    uint32_t resimTicks;
+    uint32_t stalls;        // Advance refused because a peer fell too far behind
+    int lastDepth;          // Ticks resimulated by the most recent rollback
+    int maxDepth;
+    uint32_t lastResimMicros;
+    uint32_t maxResimMicros;
+    uint64_t totalResimMicros;
+} RollbackStats;
+
+// Predict-and-correct driver around Sim_Step. states[t % RING] is the state
+// at the start of tick t and inputs[t % RING] the inputs used for it. Remote
+// inputs that are not known yet are predicted by holding the last confirmed
+// stick and releasing the buttons.
+typedef struct Rollback {
+    SimState current;
+    SimState states[ROLLBACK_RING_SIZE];
+    SimInput inputs[ROLLBACK_RING_SIZE][SIM_MAX_PLAYERS];
+    uint32_t confirmedFor[ROLLBACK_RING_SIZE][SIM_MAX_PLAYERS]; // tick + 1 once confirmed, 0 if predicted
+
+    uint32_t confirmedTick[SIM_MAX_PLAYERS]; // Every input before this tick is confirmed
+    SimInput lastConfirmed[SIM_MAX_PLAYERS];
+    uint32_t rollbackTick;                   // Oldest tick with a corrected input, or current.tick
+
+    SimWorld world;
+    RollbackStats stats;
+} Rollback;
+
+// initial->tick becomes the first tick to simulate.
+void Rollback_Init(Rollback *rb, const SimState *initial, const SimWorld *world);
+
+// Records a player's input for a tick; local players feed the tick about to
+// be simulated, remote ones whatever arrived. Returns false if the tick is
+// too far ahead to store.
+bool Rollback_AddInput(Rollback *rb, int player, uint32_t tick, SimInput input);
+
+// Resimulates from the oldest corrected tick, if any, then steps once. Stalls
+// (returns false without stepping) while that would predict further than
+// ROLLBACK_MAX_PREDICTION ticks past the slowest peer, which also bounds the
+// rollback depth.
+bool Rollback_Advance(Rollback *rb);
+
+// Every input before this tick is known, so states up to it are final.
+uint32_t Rollback_ConfirmedTick(const Rollback *rb);
+
+#endif
@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include "savestate.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SAVESTATE_HEADER_SIZE (4 * sizeof(uint32_t))
+
+// The layout must stay padding-free so the file matches the struct byte for byte:
+// the struct is exactly as big as its fields added up
+#define SAVESTATE_FIELD_BYTES                                        \
+    (4 * sizeof(uint32_t) + 5 * sizeof(float) + 2 * sizeof(int32_t) + \
+     sizeof(int32_t) + 2 * SAVESTATE_MAX_BIRDS * sizeof(float) +      \
+     2 * sizeof(int32_t) + sizeof(float) + 2 * CHAT_MAX_TEXT)
+typedef char SaveStateNoPadding[(sizeof(SaveState) == SAVESTATE_FIELD_BYTES) ? 1 : -1];
+
+static uint32_t Checksum(const unsigned char *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void SaveState_Seal(SaveState *state)
+{
+    state->magic = SAVESTATE_MAGIC;
+    state->version = SAVESTATE_VERSION;
+    state->size = (uint32_t)sizeof(SaveState);
+    state->checksum = Checksum((const unsigned char *)state + SAVESTATE_HEADER_SIZE,
+                               sizeof(SaveState) - SAVESTATE_HEADER_SIZE);
+}
+
+bool SaveState_Validate(const void *data, size_t size)
+{
+    if (!data || size != sizeof(SaveState)) return false;
+
+    const SaveState *state = (const SaveState *)data;
+    if (state->magic != SAVESTATE_MAGIC) return false;
+    if (state->version != SAVESTATE_VERSION) return false;
+    if (state->size != sizeof(SaveState)) return false;
+    if (state->birdCount < 0 || state->birdCount > SAVESTATE_MAX_BIRDS) return false;
+    if (state->chatLength < 0 || state->chatLength >= CHAT_MAX_TEXT) return false;
+    if (state->chatSentLength < 0 || state->chatSentLength >= CHAT_MAX_TEXT) return false;
+
+    return state->checksum == Checksum((const unsigned char *)data + SAVESTATE_HEADER_SIZE,
+                                       sizeof(SaveState) - SAVESTATE_HEADER_SIZE);
+}
+
+// Makes the rename itself durable. Best effort: the new snapshot is already
+// complete, at worst a power loss brings back the previous one.
+static void SyncParentDirectory(const char *path)
+{
+    char dir[512];
+    const char *slash = strrchr(path, '/');
+    if (!slash) snprintf(dir, sizeof(dir), ".");
+    else if (slash == path) snprintf(dir, sizeof(dir), "/");
+    else if ((size_t)(slash - path) < sizeof(dir)) snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+    else return;
+
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+bool SaveState_Write(const SaveState *state, const char *path)
+{
+    char tmpPath[512];
+    if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int)sizeof(tmpPath)) return false;
+
+    int fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return false;
+
+    // The data has to be on disk before the rename can point at it
+    ssize_t written = write(fd, state, sizeof(SaveState));
+    bool synced = written == (ssize_t)sizeof(SaveState) && fsync(fd) == 0;
+    close(fd);
+
+    if (!synced)
+    {
+        unlink(tmpPath);
+        return false;
+    }
+
+    if (rename(tmpPath, path) != 0)
+    {
+        unlink(tmpPath);
+        return false;
+    }
+    SyncParentDirectory(path);
+    return true;
+}
+
+bool SaveState_Read(SaveState *state, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    SaveState loaded;
+    ssize_t got = read(fd, &loaded, sizeof(loaded));
+    close(fd);
+
+    if (got != (ssize_t)sizeof(loaded) || !SaveState_Validate(&loaded, sizeof(loaded))) return false;
+
+    *state = loaded;
+    return true;
+}
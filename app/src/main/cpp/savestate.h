@@ -0,0 +1,56 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "chatlimits.h"
+
+#define SAVESTATE_MAGIC      0x31534D55u // "UMS1" in little-endian byte order
+#define SAVESTATE_VERSION    1
+#define SAVESTATE_MAX_BIRDS  16
+#define SAVESTATE_FILE_NAME  "umg_state.bin"
+
+// Fixed-layout snapshot of the session. Every field is 4 bytes wide (or a
+// char array sized to a multiple of 4), so the struct has no padding and is
+// written/read as one block. Bump SAVESTATE_VERSION whenever the layout changes.
+typedef struct SaveState {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;     // sizeof(SaveState) at write time
+    uint32_t checksum; // FNV-1a over everything after the header
+
+    float playerX;
+    float playerY;
+    float facingX;
+    float velY;
+    int32_t grounded;
+    int32_t jumpsUsed;
+    float cameraX;
+
+    int32_t birdCount;
+    float birdX[SAVESTATE_MAX_BIRDS];
+    float birdY[SAVESTATE_MAX_BIRDS];
+
+    int32_t chatLength;
+    int32_t chatSentLength;
+    float chatBubbleTimer;
+    char chatText[CHAT_MAX_TEXT];     // Text being typed
+    char chatSentText[CHAT_MAX_TEXT]; // Text shown in the bubble
+} SaveState;
+
+// Fills in magic, version, size and checksum. Call right before persisting.
+void SaveState_Seal(SaveState *state);
+
+// True if data holds a sealed SaveState of the current version.
+bool SaveState_Validate(const void *data, size_t size);
+
+// Writes the sealed state to path with a single write() into a temp file,
+// fsync()s it, then rename()s it over path and syncs the directory, so neither
+// a kill nor a power loss mid-write leaves a torn snapshot.
+bool SaveState_Write(const SaveState *state, const char *path);
+
+// Reads and validates a snapshot. state is untouched on failure.
+bool SaveState_Read(SaveState *state, const char *path);
+
+#endif
@@ -0,0 +1,65 @@
+#include "sim.h"
+#include <string.h>
+
+void Sim_InitPlayer(SimPlayer *player, float x, float y)
+{
+    memset(player, 0, sizeof(SimPlayer));
+    player->x = x;
+    player->y = y;
+    player->facingX = 1.0f;
+    player->grounded = 1;
+}
+
+static void StepPlayer(SimPlayer *p, SimInput input, const SimWorld *world)
+{
+    p->events = 0;
+
+    if (input.moveX > 1 || input.moveX < -1) p->facingX = (input.moveX > 0) ? 1.0f : -1.0f;
+
+    if ((input.buttons & SIM_BUTTON_JUMP) && p->jumpsUsed < SIM_MAX_JUMPS)
+    {
+        p->velY = SIM_JUMP_VELOCITY;
+        p->grounded = 0;
+        p->jumpsUsed++;
+        p->events |= SIM_EVENT_JUMP;
+    }
+
+    p->velY += SIM_GRAVITY;
+
+    CollisionBox body = { p->x - SIM_PLAYER_HALF_WIDTH, p->y - SIM_PLAYER_HEAD_ROOM,
+                          SIM_PLAYER_HALF_WIDTH * 2, SIM_PLAYER_HEAD_ROOM + SIM_PLAYER_FOOT_DEPTH, 0 };
+    CollisionMove move;
+    Collision_Move(world->collision, &body, input.moveX * (SIM_RUN_SPEED / 127.0f), p->velY,
+                   p->grounded != 0, &move);
+    p->x = body.x + SIM_PLAYER_HALF_WIDTH;
+    p->y = body.y + SIM_PLAYER_HEAD_ROOM;
+
+    p->grounded = move.landed;
+    if (move.landed)
+    {
+        p->velY = 0;
+        p->jumpsUsed = 0;
+    }
+    if (move.hitCeiling) p->velY = 0;
+
+    if (p->x < 0.0f) p->x = 0.0f;
+    if (p->x > world->worldWidth) p->x = world->worldWidth;
+}
+
+void Sim_Step(SimState *state, const SimInput *inputs, const SimWorld *world)
+{
+    for (int i = 0; i < state->playerCount; i++) StepPlayer(&state->players[i], inputs[i], world);
+    state->tick++;
+}
+
+uint32_t Sim_Checksum(const SimState *state)
+{
+    const unsigned char *data = (const unsigned char *)state;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(SimState); i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
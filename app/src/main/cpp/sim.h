@@ -0,0 +1,65 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "collision.h"
+
+#define SIM_MAX_PLAYERS    8
+
+#define SIM_GRAVITY        0.6f
+#define SIM_JUMP_VELOCITY -12.0f
+#define SIM_MAX_JUMPS      2
+#define SIM_RUN_SPEED      5.5f // Per tick at full stick
+
+#define SIM_PLAYER_HALF_WIDTH 9.0f
+#define SIM_PLAYER_HEAD_ROOM  46.0f // y to the top of the head
+#define SIM_PLAYER_FOOT_DEPTH 24.0f // y to the soles
+
+typedef enum SimButtons {
+    SIM_BUTTON_JUMP = 1 << 0 // Pressed this tick (edge, not held)
+} SimButtons;
+
+typedef enum SimEvents {
+    SIM_EVENT_JUMP = 1 << 0
+} SimEvents;
+
+// One player's input for one tick. Stick is quantized so peers simulate
+// bit-identical input.
+typedef struct SimInput {
+    int8_t moveX;    // -127..127
+    uint8_t buttons; // SimButtons
+} SimInput;
+
+typedef struct SimPlayer {
+    float x, y;
+    float velY;
+    float facingX;
+    int32_t grounded;
+    int32_t jumpsUsed;
+    uint32_t events; // SimEvents raised by the last step
+} SimPlayer;
+
+// Everything the deterministic step reads or writes. Plain data with no
+// pointers, so a snapshot is a single memcpy.
+typedef struct SimState {
+    uint32_t tick;
+    int32_t playerCount;
+    SimPlayer players[SIM_MAX_PLAYERS];
+} SimState;
+
+// Read-only context shared by every step
+typedef struct SimWorld {
+    const CollisionWorld *collision;
+    float worldWidth;
+} SimWorld;
+
+void Sim_InitPlayer(SimPlayer *player, float x, float y);
+
+// Advances state by one tick. inputs holds one entry per player.
+void Sim_Step(SimState *state, const SimInput *inputs, const SimWorld *world);
+
+// FNV-1a over the state, for comparing peers.
+uint32_t Sim_Checksum(const SimState *state);
+
+#endif
@@ -0,0 +1,227 @@
+#include "sprites.h"
+#include "gpumem.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(PLATFORM_ANDROID)
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#endif
+
+/* =============================
+   SHADERS (GLSL ES 1.00)
+============================= */
+static const char *spriteVs =
+    "#version 100\n"
+    "attribute vec4 vertexShape;\n"   // xy local offset, z flap weight, w round mask
+    "attribute vec4 instanceData;\n"  // xy position, z scale, w phase
+    "attribute float instanceRate;\n"
+    "attribute vec4 instanceTint;\n"
+    "uniform mat4 mvp;\n"
+    "uniform float time;\n"
+    "uniform float alpha;\n"
+    "uniform float flap;\n"           // 0 = twinkle alpha, 1 = flap geometry
+    "varying vec2 fragLocal;\n"
+    "varying float fragMask;\n"
+    "varying vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    float wave = sin(time*instanceRate + instanceData.w);\n"
+    "    vec2 local = vertexShape.xy;\n"
+    "    local.y += flap*(1.0 + wave)*vertexShape.z;\n"
+    "    float twinkle = mix(0.6 + 0.4*wave, 1.0, flap);\n"
+    "    fragLocal = vertexShape.xy;\n"
+    "    fragMask = vertexShape.w;\n"
+    "    fragColor = vec4(instanceTint.rgb, instanceTint.a*alpha*twinkle);\n"
+    "    gl_Position = mvp*vec4(instanceData.xy + local*instanceData.z, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *spriteFs =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "varying vec2 fragLocal;\n"
+    "varying float fragMask;\n"
+    "varying vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    if (fragMask > 0.5 && dot(fragLocal, fragLocal) > 1.0) discard;\n"
+    "    gl_FragColor = fragColor;\n"
+    "}\n";
+
+/* =============================
+   SHAPES
+============================= */
+// Star: unit quad masked to a circle, scaled by the instance radius.
+// Bird: the old pair of 1px lines (0,0)-(6,flap)-(12,0) as thin quads,
+// with the middle vertices carrying the flap weight.
+static const float shapeVertices[] = {
+    -1, -1, 0, 1,   1, -1, 0, 1,   1, 1, 0, 1,
+    -1, -1, 0, 1,   1,  1, 0, 1,  -1, 1, 0, 1,
+
+     0, -0.5f, 0, 0,   6, -0.5f, 1, 0,   6, 0.5f, 1, 0,
+     0, -0.5f, 0, 0,   6,  0.5f, 1, 0,   0, 0.5f, 0, 0,
+     6, -0.5f, 1, 0,  12, -0.5f, 0, 0,  12, 0.5f, 0, 0,
+     6, -0.5f, 1, 0,  12,  0.5f, 0, 0,   6, 0.5f, 1, 0,
+};
+
+static const int shapeFirst[SPRITE_CLASS_COUNT] = { 0, 6 };
+static const int shapeCount[SPRITE_CLASS_COUNT] = { 6, 12 };
+
+/* =============================
+   STATE
+============================= */
+static struct {
+    bool ready;
+    unsigned int shader;
+    unsigned int shapeVbo;
+    unsigned int instanceVbo[SPRITE_CLASS_COUNT];
+    int locShape, locData, locRate, locTint;
+    int locMvp, locTime, locAlpha, locFlap;
+} sprites;
+
+#if defined(PLATFORM_ANDROID)
+// raylib runs an ES2 context, where instancing is the GL_EXT_instanced_arrays extension
+static PFNGLDRAWARRAYSINSTANCEDEXTPROC drawArraysInstanced;
+static PFNGLVERTEXATTRIBDIVISOREXTPROC vertexAttribDivisor;
+
+static bool LoadInstancing(void)
+{
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    if (!extensions || !strstr(extensions, "GL_EXT_instanced_arrays")) return false;
+
+    drawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDEXTPROC)eglGetProcAddress("glDrawArraysInstancedEXT");
+    vertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISOREXTPROC)eglGetProcAddress("glVertexAttribDivisorEXT");
+    return drawArraysInstanced && vertexAttribDivisor;
+}
+
+static void SetDivisor(int index, int divisor) { vertexAttribDivisor((GLuint)index, (GLuint)divisor); }
+static void DrawInstanced(int first, int count, int instances) { drawArraysInstanced(GL_TRIANGLES, first, count, instances); }
+#else
+// The shaders target GLSL ES; desktop builds keep the immediate-mode path,
+// so Sprites_Init fails there and nothing below ever draws instanced
+static bool LoadInstancing(void) { return false; }
+static void SetDivisor(int index, int divisor) { (void)index; (void)divisor; }
+static void DrawInstanced(int first, int count, int instances) { (void)first; (void)count; (void)instances; }
+#endif
+
+bool Sprites_Init(void)
+{
+    if (sprites.ready) return true;
+    if (!LoadInstancing()) return false;
+
+    sprites.shader = rlLoadShaderCode(spriteVs, spriteFs);
+    if (sprites.shader == 0) return false;
+
+    sprites.locShape = rlGetLocationAttrib(sprites.shader, "vertexShape");
+    sprites.locData = rlGetLocationAttrib(sprites.shader, "instanceData");
+    sprites.locRate = rlGetLocationAttrib(sprites.shader, "instanceRate");
+    sprites.locTint = rlGetLocationAttrib(sprites.shader, "instanceTint");
+    sprites.locMvp = rlGetLocationUniform(sprites.shader, "mvp");
+    sprites.locTime = rlGetLocationUniform(sprites.shader, "time");
+    sprites.locAlpha = rlGetLocationUniform(sprites.shader, "alpha");
+    sprites.locFlap = rlGetLocationUniform(sprites.shader, "flap");
+
+    if (sprites.locShape < 0 || sprites.locData < 0 || sprites.locRate < 0 || sprites.locTint < 0)
+    {
+        rlUnloadShaderProgram(sprites.shader);
+        return false;
+    }
+
+    // Over budget: allocate nothing and let callers draw immediate-mode
+    size_t instanceBytes = SPRITES_MAX_INSTANCES * sizeof(SpriteInstance);
+    size_t needed = sizeof(shapeVertices) + SPRITE_CLASS_COUNT * instanceBytes;
+    if (GpuMem_Used() + needed > GpuMem_Budget())
+    {
+        rlUnloadShaderProgram(sprites.shader);
+        return false;
+    }
+
+    sprites.shapeVbo = rlLoadVertexBuffer(shapeVertices, sizeof(shapeVertices), false);
+    GpuMem_Track(GPUMEM_BUFFER, sprites.shapeVbo, "sprite vb",
+                 (int)(sizeof(shapeVertices) / (4 * sizeof(float))), 1, 0, sizeof(shapeVertices));
+
+    for (int i = 0; i < SPRITE_CLASS_COUNT; i++)
+    {
+        sprites.instanceVbo[i] = rlLoadVertexBuffer(NULL, (int)instanceBytes, true);
+        GpuMem_Track(GPUMEM_BUFFER, sprites.instanceVbo[i], "sprite ib",
+                     SPRITES_MAX_INSTANCES, 1, 0, instanceBytes);
+    }
+
+    sprites.ready = true;
+    return true;
+}
+
+void Sprites_Unload(void)
+{
+    if (!sprites.ready) return;
+
+    for (int i = 0; i < SPRITE_CLASS_COUNT; i++)
+    {
+        GpuMem_Untrack(GPUMEM_BUFFER, sprites.instanceVbo[i]);
+        rlUnloadVertexBuffer(sprites.instanceVbo[i]);
+    }
+    GpuMem_Untrack(GPUMEM_BUFFER, sprites.shapeVbo);
+    rlUnloadVertexBuffer(sprites.shapeVbo);
+    rlUnloadShaderProgram(sprites.shader);
+    memset(&sprites, 0, sizeof(sprites));
+}
+
+bool Sprites_Available(void)
+{
+    return sprites.ready;
+}
+
+void Sprites_Draw(SpriteClass spriteClass, const SpriteInstance *instances, int count, float time, float alpha)
+{
+    if (!sprites.ready || count <= 0) return;
+    if (count > SPRITES_MAX_INSTANCES) count = SPRITES_MAX_INSTANCES;
+
+    // Everything raylib batched so far has to land before our draw
+    rlDrawRenderBatchActive();
+
+    unsigned int instanceVbo = sprites.instanceVbo[spriteClass];
+    rlUpdateVertexBuffer(instanceVbo, instances, count * (int)sizeof(SpriteInstance), 0);
+
+    rlEnableShader(sprites.shader);
+
+    // Include any rlPushMatrix transform, which raylib itself applies per vertex
+    Matrix modelview = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix mvp = MatrixMultiply(modelview, rlGetMatrixProjection());
+    float flap = (spriteClass == SPRITE_CLASS_BIRD) ? 1.0f : 0.0f;
+    rlSetUniformMatrix(sprites.locMvp, mvp);
+    rlSetUniform(sprites.locTime, &time, RL_SHADER_UNIFORM_FLOAT, 1);
+    rlSetUniform(sprites.locAlpha, &alpha, RL_SHADER_UNIFORM_FLOAT, 1);
+    rlSetUniform(sprites.locFlap, &flap, RL_SHADER_UNIFORM_FLOAT, 1);
+
+    rlEnableVertexBuffer(sprites.shapeVbo);
+    rlSetVertexAttribute(sprites.locShape, 4, RL_FLOAT, false, 4 * sizeof(float), 0);
+    rlEnableVertexAttribute(sprites.locShape);
+
+    rlEnableVertexBuffer(instanceVbo);
+    rlSetVertexAttribute(sprites.locData, 4, RL_FLOAT, false, sizeof(SpriteInstance), offsetof(SpriteInstance, x));
+    rlSetVertexAttribute(sprites.locRate, 1, RL_FLOAT, false, sizeof(SpriteInstance), offsetof(SpriteInstance, rate));
+    rlSetVertexAttribute(sprites.locTint, 4, RL_UNSIGNED_BYTE, true, sizeof(SpriteInstance), offsetof(SpriteInstance, tint));
+    rlEnableVertexAttribute(sprites.locData);
+    rlEnableVertexAttribute(sprites.locRate);
+    rlEnableVertexAttribute(sprites.locTint);
+    SetDivisor(sprites.locData, 1);
+    SetDivisor(sprites.locRate, 1);
+    SetDivisor(sprites.locTint, 1);
+
+    DrawInstanced(shapeFirst[spriteClass], shapeCount[spriteClass], count);
+
+    // Divisors are global attribute state without VAOs; raylib's batch expects 0
+    SetDivisor(sprites.locData, 0);
+    SetDivisor(sprites.locRate, 0);
+    SetDivisor(sprites.locTint, 0);
+    rlDisableVertexAttribute(sprites.locShape);
+    rlDisableVertexAttribute(sprites.locData);
+    rlDisableVertexAttribute(sprites.locRate);
+    rlDisableVertexAttribute(sprites.locTint);
+    rlDisableVertexBuffer();
+    rlDisableShader();
+}
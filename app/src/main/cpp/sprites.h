@@ -0,0 +1,34 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <stdbool.h>
+
+#define SPRITES_MAX_INSTANCES 4096 // Per class, per draw
+
+typedef enum SpriteClass {
+    SPRITE_CLASS_STAR = 0, // Round dot, alpha twinkles with sin(time * rate + phase)
+    SPRITE_CLASS_BIRD,     // Two-segment wing, tip flaps with sin(time * rate + phase)
+    SPRITE_CLASS_COUNT
+} SpriteClass;
+
+// Per-instance vertex data, 24 bytes. Animation is evaluated on the GPU from
+// phase/rate and a time uniform, so the data only changes when sprites move.
+typedef struct SpriteInstance {
+    float x, y;
+    float scale;
+    float phase;
+    float rate;
+    unsigned char tint[4];
+} SpriteInstance;
+
+// Compiles the shader and creates the buffers. Returns false when the GL
+// context has no instancing support; callers keep their immediate-mode path.
+bool Sprites_Init(void);
+void Sprites_Unload(void);
+bool Sprites_Available(void);
+
+// Uploads the instances and draws the whole class in a single call.
+// Uses the current blend mode and raylib's current modelview/projection.
+void Sprites_Draw(SpriteClass spriteClass, const SpriteInstance *instances, int count, float time, float alpha);
+
+#endif
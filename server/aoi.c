@@ -0,0 +1,226 @@
+#include "aoi.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int CellOf(const AoiGrid *grid, float x)
+{
+    if (!(x > 0.0f)) return 0;
+    float cell = x / grid->cellWidth;
+    return cell < (float)grid->cellCount ? (int)cell : grid->cellCount - 1;
+}
+
+bool Aoi_Init(AoiGrid *grid, int capacity, float worldWidth)
+{
+    memset(grid, 0, sizeof(AoiGrid));
+    grid->capacity = capacity;
+    grid->worldWidth = worldWidth;
+
+    // Enough cells to cover the world, so no stretch of it piles into one
+    grid->cellWidth = AOI_CELL_WIDTH;
+    grid->cellCount = AOI_UNBOUNDED_CELLS;
+    if (worldWidth > 0.0f)
+    {
+        if (worldWidth > AOI_CELL_WIDTH * AOI_MAX_CELLS) grid->cellWidth = worldWidth / AOI_MAX_CELLS;
+        grid->cellCount = (int)ceilf(worldWidth / grid->cellWidth);
+        if (grid->cellCount < 1) grid->cellCount = 1;
+        if (grid->cellCount > AOI_MAX_CELLS) grid->cellCount = AOI_MAX_CELLS;
+    }
+
+    grid->x = malloc(sizeof(float) * (size_t)capacity);
+    grid->cellStart = calloc((size_t)grid->cellCount + 1, sizeof(uint32_t));
+    grid->cursor = malloc(sizeof(uint32_t) * (size_t)grid->cellCount);
+    grid->cellItems = malloc(sizeof(uint16_t) * (size_t)capacity);
+    grid->marks = calloc((size_t)capacity, sizeof(uint32_t));
+    if (!grid->x || !grid->cellStart || !grid->cursor || !grid->cellItems || !grid->marks)
+    {
+        Aoi_Free(grid);
+        return false;
+    }
+
+    for (int i = 0; i < capacity; i++) grid->x[i] = NAN;
+    return true;
+}
+
+void Aoi_Free(AoiGrid *grid)
+{
+    free(grid->x);
+    free(grid->cellStart);
+    free(grid->cursor);
+    free(grid->cellItems);
+    free(grid->marks);
+    memset(grid, 0, sizeof(AoiGrid));
+}
+
+void Aoi_SetPosition(AoiGrid *grid, int slot, float x)
+{
+    // A NaN from the wire would read as absent; park it at the origin instead
+    grid->x[slot] = isnan(x) ? 0.0f : x;
+}
+
+void Aoi_Remove(AoiGrid *grid, int slot)
+{
+    grid->x[slot] = NAN;
+}
+
+void Aoi_Build(AoiGrid *grid)
+{
+    uint32_t *cellStart = grid->cellStart;
+    uint32_t *cursor = grid->cursor;
+    memset(cellStart, 0, sizeof(uint32_t) * ((size_t)grid->cellCount + 1));
+
+    // Count per cell, prefix-sum into start offsets, then fill
+    for (int slot = 0; slot < grid->capacity; slot++)
+        if (!isnan(grid->x[slot])) cellStart[CellOf(grid, grid->x[slot]) + 1]++;
+    for (int c = 0; c < grid->cellCount; c++) cellStart[c + 1] += cellStart[c];
+
+    memcpy(cursor, cellStart, sizeof(uint32_t) * (size_t)grid->cellCount);
+    for (int slot = 0; slot < grid->capacity; slot++)
+        if (!isnan(grid->x[slot])) grid->cellItems[cursor[CellOf(grid, grid->x[slot])]++] = (uint16_t)slot;
+}
+
+// Newcomer picks, kept sorted by distance and then slot so that equal
+// distances always resolve the same way from one tick to the next
+static void InsertNearest(uint16_t *slots, float *distances, int *count, int room, int slot, float distance)
+{
+    int i = *count;
+    if (i == room)
+    {
+        // Full: only a nearer candidate displaces the farthest pick
+        if (distance > distances[i - 1] || (distance == distances[i - 1] && slot > slots[i - 1])) return;
+        i--;
+    }
+    else (*count)++;
+
+    while (i > 0 && (distances[i - 1] > distance || (distances[i - 1] == distance && slots[i - 1] > slot)))
+    {
+        slots[i] = slots[i - 1];
+        distances[i] = distances[i - 1];
+        i--;
+    }
+    slots[i] = (uint16_t)slot;
+    distances[i] = distance;
+}
+
+void Aoi_Update(AoiGrid *grid, AoiView *view, int self, float viewerX, uint32_t tick, AoiUpdate *out)
+{
+    // Two stamps per call: "was visible" and "visible now". Restart before they wrap.
+    if (grid->generation > UINT32_MAX - 2)
+    {
+        memset(grid->marks, 0, sizeof(uint32_t) * (size_t)grid->capacity);
+        grid->generation = 0;
+    }
+    uint32_t was = grid->generation + 1;
+    uint32_t now = grid->generation + 2;
+    grid->generation = now;
+
+    for (int i = 0; i < view->visibleCount; i++) grid->marks[view->visible[i]] = was;
+
+    float camLeft = viewerX - AOI_VIEW_WIDTH * AOI_VIEW_LEAD;
+    if (grid->worldWidth > 0.0f && camLeft > grid->worldWidth - AOI_VIEW_WIDTH)
+        camLeft = grid->worldWidth - AOI_VIEW_WIDTH;
+    if (camLeft < 0.0f) camLeft = 0.0f;
+    float camRight = camLeft + AOI_VIEW_WIDTH;
+    float center = camLeft + AOI_VIEW_WIDTH * 0.5f;
+
+    uint16_t next[AOI_MAX_VISIBLE];
+    int count = 0;
+    out->sendCount = 0;
+
+    // Everyone already in view stays until they pass the leave margin (or
+    // disconnect, which reads as NaN), ahead of any newcomer
+    for (int i = 0; i < view->visibleCount; i++)
+    {
+        int slot = view->visible[i];
+        float x = grid->x[slot];
+        if (!(x >= camLeft - AOI_LEAVE_MARGIN && x <= camRight + AOI_LEAVE_MARGIN)) continue;
+
+        next[count++] = (uint16_t)slot;
+        grid->marks[slot] = now;
+
+        bool onScreen = x >= camLeft && x <= camRight;
+        if (onScreen || (tick + (uint32_t)slot) % AOI_FAR_INTERVAL == 0)
+            out->send[out->sendCount++] = (uint16_t)slot;
+    }
+
+    // Free places go to the nearest newcomers. Cells are walked outward from
+    // the camera centre until the next one cannot hold anyone nearer than the
+    // farthest pick so far.
+    int room = AOI_MAX_VISIBLE - count;
+    uint16_t picks[AOI_MAX_VISIBLE];
+    float pickDistances[AOI_MAX_VISIBLE];
+    int pickCount = 0;
+
+    int first = CellOf(grid, camLeft - AOI_ENTER_MARGIN);
+    int last = CellOf(grid, camRight + AOI_ENTER_MARGIN);
+    int lo = CellOf(grid, center), hi = lo + 1;
+
+    while (room > 0 && (lo >= first || hi <= last))
+    {
+        // Distance from the centre to the near edge of each candidate cell
+        float loGap = center - (lo + 1) * grid->cellWidth;
+        float hiGap = hi * grid->cellWidth - center;
+        int cell;
+        float gap;
+        if (hi > last || (lo >= first && loGap <= hiGap))
+        {
+            cell = lo--;
+            gap = loGap;
+        }
+        else
+        {
+            cell = hi++;
+            gap = hiGap;
+        }
+        if (pickCount == room && gap > pickDistances[pickCount - 1]) break;
+
+        for (uint32_t k = grid->cellStart[cell]; k < grid->cellStart[cell + 1]; k++)
+        {
+            int slot = grid->cellItems[k];
+            if (slot == self || grid->marks[slot] == now) continue;
+
+            float x = grid->x[slot];
+            if (!(x >= camLeft - AOI_ENTER_MARGIN && x <= camRight + AOI_ENTER_MARGIN)) continue;
+            InsertNearest(picks, pickDistances, &pickCount, room, slot, fabsf(x - center));
+        }
+    }
+
+    // Newcomers go out at once so they appear without a gap
+    for (int i = 0; i < pickCount; i++)
+    {
+        next[count++] = picks[i];
+        grid->marks[picks[i]] = now;
+        out->send[out->sendCount++] = picks[i];
+    }
+
+    // Someone back in view before their leave notice went out needs none
+    int pending = 0;
+    for (int i = 0; i < view->leavingCount; i++)
+        if (grid->marks[view->leaving[i]] != now) view->leaving[pending++] = view->leaving[i];
+    view->leavingCount = pending;
+
+    uint16_t gone[AOI_MAX_VISIBLE];
+    int goneCount = 0;
+    for (int i = 0; i < view->visibleCount; i++)
+        if (grid->marks[view->visible[i]] == was) gone[goneCount++] = view->visible[i];
+
+    int overflow = view->leavingCount + goneCount - AOI_MAX_LEAVING;
+    if (overflow > 0) Aoi_DropLeaves(view, overflow);
+    memcpy(view->leaving + view->leavingCount, gone, sizeof(uint16_t) * (size_t)goneCount);
+    view->leavingCount += goneCount;
+
+    memcpy(view->visible, next, sizeof(uint16_t) * (size_t)count);
+    view->visibleCount = count;
+}
+
+void Aoi_DropLeaves(AoiView *view, int count)
+{
+    if (count > view->leavingCount) count = view->leavingCount;
+    view->leavingCount -= count;
+    memmove(view->leaving, view->leaving + count, sizeof(uint16_t) * (size_t)view->leavingCount);
+}
+
+bool Aoi_InView(const AoiGrid *grid, int slot)
+{
+    return grid->marks[slot] == grid->generation;
+}
@@ -0,0 +1,85 @@
+#ifndef AOI_H
+#define AOI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Area of interest: which players each client gets told about. The world is
+// one-dimensional for this purpose, so players are bucketed by x alone.
+
+// Cells are AOI_CELL_WIDTH wide and cover the whole world. Past
+// AOI_MAX_CELLS of them the cells widen instead. An unbounded world gets
+// AOI_UNBOUNDED_CELLS, and positions beyond the last cell share it.
+#define AOI_CELL_WIDTH      128.0f
+#define AOI_MAX_CELLS       65536
+#define AOI_UNBOUNDED_CELLS 256
+#define AOI_MAX_VISIBLE   64    // Players in one client's view
+#define AOI_MAX_LEAVING   128   // Leave notices a client can have outstanding
+
+// Mirrors the game camera: SCREEN_WIDTH wide, player 40% in from the left,
+// clamped to the world
+#define AOI_VIEW_WIDTH    480.0f
+#define AOI_VIEW_LEAD     0.4f
+
+// Hysteresis: a player enters the view within ENTER of the camera edges and
+// only leaves beyond LEAVE, so someone pacing along the edge does not flicker.
+// A full view is never reshuffled either: players already in it keep their
+// place until they really leave, and only free places go to the nearest
+// newcomers.
+#define AOI_ENTER_MARGIN  64.0f
+#define AOI_LEAVE_MARGIN  192.0f
+
+// Players outside the camera proper (in the margins) are updated every
+// AOI_FAR_INTERVAL ticks instead of every tick
+#define AOI_FAR_INTERVAL  2
+
+// Rebuilt once per tick. Cell c owns the slots
+// cellItems[cellStart[c] .. cellStart[c + 1]).
+typedef struct AoiGrid {
+    int capacity;
+    float worldWidth;   // 0 means unbounded on the right
+    int cellCount;
+    float cellWidth;
+    float *x;           // Per slot, NAN when absent
+    uint32_t *cellStart; // cellCount + 1 entries
+    uint32_t *cursor;   // cellCount entries, scratch for Aoi_Build
+    uint16_t *cellItems;
+    uint32_t *marks;    // Per slot visibility stamps, see Aoi_Update
+    uint32_t generation;
+} AoiGrid;
+
+// Persistent per-client view. Leaves queue up until the caller has told the
+// client about them, oldest first; past AOI_MAX_LEAVING the oldest are
+// dropped and left to the client's own peer timeout.
+typedef struct AoiView {
+    uint16_t visible[AOI_MAX_VISIBLE];
+    int visibleCount;
+    uint16_t leaving[AOI_MAX_LEAVING];
+    int leavingCount;
+} AoiView;
+
+typedef struct AoiUpdate {
+    uint16_t send[AOI_MAX_VISIBLE]; // Due for an update this tick
+    int sendCount;
+} AoiUpdate;
+
+bool Aoi_Init(AoiGrid *grid, int capacity, float worldWidth);
+void Aoi_Free(AoiGrid *grid);
+
+void Aoi_SetPosition(AoiGrid *grid, int slot, float x);
+void Aoi_Remove(AoiGrid *grid, int slot);
+
+// Buckets every present slot. Call once per tick before any Aoi_Update.
+void Aoi_Build(AoiGrid *grid);
+
+// Recomputes a viewer's visible set and queues leave notices for whoever
+// dropped out of it. self is never included.
+void Aoi_Update(AoiGrid *grid, AoiView *view, int self, float viewerX, uint32_t tick, AoiUpdate *out);
+
+// Forgets the count oldest leave notices, once they have been sent.
+void Aoi_DropLeaves(AoiView *view, int count);
+
+// True if slot is in the view computed by the most recent Aoi_Update call.
+bool Aoi_InView(const AoiGrid *grid, int slot);
+
+#endif
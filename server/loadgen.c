@@ -0,0 +1,387 @@
+// Load generator for umg_server: simulates many game clients on one machine,
+// each on its own UDP socket, and reports throughput and latency.
+//
+//   umg_loadgen [-h host] [-p port] [-n clients] [-d seconds] [-r state rate] [-m chat every s]
+//               [-w world width]
+//
+// Clients walk back and forth across a world of the given width, so -n and
+// -w together set the crowd density the server's area-of-interest culling sees.
+//
+// Latency is measured two ways. "state" is the round trip from sending a
+// STATE to getting it echoed in a snapshot, which includes the wait for the
+// next server tick. "chat" is the round trip of a chat line to its own relay.
+#include "netproto.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HISTOGRAM_BUCKET_US 50
+#define HISTOGRAM_BUCKETS   40000 // 2 s
+#define HELLO_RETRY_MS      500
+#define EVENT_BATCH         256
+
+typedef struct {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint32_t maxMicros;
+} Histogram;
+
+typedef struct {
+    int sock;
+    int id;             // -1 until WELCOMEd
+    uint64_t nextSendUs;
+    uint64_t nextChatUs;
+    uint64_t lastHelloUs;
+    uint32_t lastTick;  // Snapshot tick already measured
+    float x, dir;
+} Client;
+
+typedef struct {
+    uint64_t packetsOut, bytesOut;
+    uint64_t packetsIn, bytesIn;
+    uint64_t snapshots, entities, leaves, chats;
+} Counters;
+
+static volatile sig_atomic_t running = 1;
+static Histogram stateLatency, chatLatency;
+static Counters counters;
+
+static void OnSignal(int sig)
+{
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t NowMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void Record(Histogram *h, uint32_t micros)
+{
+    uint32_t bucket = micros / HISTOGRAM_BUCKET_US;
+    if (bucket >= HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS - 1;
+    h->counts[bucket]++;
+    h->total++;
+    if (micros > h->maxMicros) h->maxMicros = micros;
+}
+
+static double Percentile(const Histogram *h, double p)
+{
+    if (h->total == 0) return 0.0;
+    uint64_t target = (uint64_t)(h->total * p);
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += h->counts[i];
+        if (seen > target)
+        {
+            uint32_t upper = (uint32_t)(i + 1) * HISTOGRAM_BUCKET_US;
+            return (upper < h->maxMicros ? upper : h->maxMicros) / 1000.0;
+        }
+    }
+    return h->maxMicros / 1000.0;
+}
+
+static void PrintLatency(const char *name, const Histogram *h)
+{
+    printf("%-6s latency ms: p50 %7.2f  p90 %7.2f  p99 %7.2f  p99.9 %7.2f  max %7.2f  (%llu samples)\n",
+           name, Percentile(h, 0.50), Percentile(h, 0.90), Percentile(h, 0.99), Percentile(h, 0.999),
+           h->maxMicros / 1000.0, (unsigned long long)h->total);
+}
+
+static void Send(Client *c, const NetWriter *w)
+{
+    if (send(c->sock, w->data, (size_t)w->size, 0) == w->size)
+    {
+        counters.packetsOut++;
+        counters.bytesOut += (uint64_t)w->size;
+    }
+}
+
+static void SendHello(Client *c, uint64_t now)
+{
+    uint8_t buffer[NET_HEADER_SIZE];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, NET_MSG_HELLO);
+    Send(c, &w);
+    c->lastHelloUs = now;
+}
+
+static void SendState(Client *c, uint64_t now, float worldWidth)
+{
+    c->x += c->dir * 5.5f * 3.0f;
+    if (c->x < 0.0f || c->x > worldWidth) c->dir = -c->dir;
+
+    uint8_t buffer[32];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, NET_MSG_STATE);
+    Net_WriteU32(&w, (uint32_t)now);
+    Net_WriteF32(&w, c->x);
+    Net_WriteF32(&w, 520.0f);
+    Net_WriteU8(&w, (uint8_t)(int8_t)(c->dir > 0 ? 1 : -1));
+    Net_WriteU8(&w, NET_FLAG_GROUNDED);
+    Send(c, &w);
+}
+
+static void SendChat(Client *c, uint64_t now)
+{
+    static const char text[] = "hello from the load generator";
+    uint8_t buffer[NET_MAX_PACKET];
+    NetWriter w = Net_Writer(buffer, sizeof(buffer));
+    Net_WriteHeader(&w, NET_MSG_CHAT);
+    Net_WriteU32(&w, (uint32_t)now);
+    Net_WriteU8(&w, (uint8_t)(sizeof(text) - 1));
+    Net_WriteBytes(&w, text, (int)sizeof(text) - 1);
+    Send(c, &w);
+}
+
+static void HandlePacket(Client *c, const uint8_t *data, int size, uint64_t now)
+{
+    NetReader r = Net_Reader(data, size);
+    switch (Net_ReadHeader(&r))
+    {
+        case NET_MSG_WELCOME:
+            c->id = Net_ReadU16(&r);
+            break;
+        case NET_MSG_SNAPSHOT:
+        {
+            uint32_t tick = Net_ReadU32(&r);
+            uint32_t echo = Net_ReadU32(&r);
+            uint16_t count = Net_ReadU16(&r);
+            if (r.overflow) return;
+
+            counters.snapshots++;
+            counters.entities += count;
+            for (int i = 0; i < count; i++)
+            {
+                uint8_t entity[NET_ENTITY_SIZE];
+                Net_ReadBytes(&r, entity, NET_ENTITY_SIZE);
+                if (!r.overflow && (entity[NET_ENTITY_SIZE - 1] & NET_FLAG_LEFT)) counters.leaves++;
+            }
+            // Each tick is one packet per client; a duplicated datagram is not measured twice
+            if (echo != 0 && tick != c->lastTick)
+            {
+                Record(&stateLatency, (uint32_t)now - echo);
+                c->lastTick = tick;
+            }
+            break;
+        }
+        case NET_MSG_CHAT_RELAY:
+        {
+            int id = Net_ReadU16(&r);
+            uint32_t sent = Net_ReadU32(&r);
+            if (r.overflow) return;
+
+            counters.chats++;
+            if (id == c->id) Record(&chatLatency, (uint32_t)now - sent);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void RaiseFileLimit(int needed)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+    if (limit.rlim_cur >= (rlim_t)needed) return;
+
+    limit.rlim_cur = (limit.rlim_max < (rlim_t)needed) ? limit.rlim_max : (rlim_t)needed;
+    setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+int main(int argc, char **argv)
+{
+    const char *host = "127.0.0.1";
+    int port = NET_DEFAULT_PORT;
+    int clientCount = 500;
+    int duration = 10;
+    int stateRate = NET_TICK_RATE;
+    int chatEvery = 5;
+    float worldWidth = 4000.0f;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:n:d:r:m:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'h': host = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'n': clientCount = atoi(optarg); break;
+            case 'd': duration = atoi(optarg); break;
+            case 'r': stateRate = atoi(optarg); break;
+            case 'm': chatEvery = atoi(optarg); break;
+            case 'w': worldWidth = (float)atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-h host] [-p port] [-n clients] [-d seconds] "
+                                "[-r state rate] [-m chat every s] [-w world width]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (clientCount <= 0 || stateRate <= 0 || duration <= 0 || worldWidth <= 0.0f) return 2;
+
+    struct sockaddr_in server = { 0 };
+    server.sin_family = AF_INET;
+    server.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &server.sin_addr) != 1)
+    {
+        fprintf(stderr, "umg_loadgen: %s is not an IPv4 address\n", host);
+        return 2;
+    }
+
+    RaiseFileLimit(clientCount + 16);
+    signal(SIGINT, OnSignal);
+
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    Client *clients = calloc((size_t)clientCount, sizeof(Client));
+    if (epoll < 0 || !clients) return 1;
+
+    uint64_t start = NowMicros();
+    uint64_t statePeriod = 1000000u / (uint64_t)stateRate;
+    for (int i = 0; i < clientCount; i++)
+    {
+        Client *c = &clients[i];
+        c->id = -1;
+        c->sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (c->sock < 0 || connect(c->sock, (struct sockaddr *)&server, sizeof(server)) != 0)
+        {
+            fprintf(stderr, "umg_loadgen: socket %i: %s\n", i, strerror(errno));
+            return 1;
+        }
+
+        struct epoll_event ev = { 0 };
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, c->sock, &ev);
+
+        // Stagger sends so the clients do not all fire in the same millisecond
+        c->nextSendUs = start + statePeriod * (uint64_t)i / (uint64_t)clientCount;
+        c->nextChatUs = start + (uint64_t)chatEvery * 1000000u * (uint64_t)i / (uint64_t)clientCount;
+        c->x = worldWidth * (float)i / (float)clientCount;
+        c->dir = (i & 1) ? 1.0f : -1.0f;
+        SendHello(c, start);
+    }
+
+    // 1 ms pacing timer drives all sends
+    int timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec period = { { 0, 1000000 }, { 0, 1000000 } };
+    timerfd_settime(timer, 0, &period, NULL);
+    struct epoll_event tev = { 0 };
+    tev.events = EPOLLIN;
+    tev.data.u32 = UINT32_MAX;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &tev);
+
+    uint64_t end = start + (uint64_t)duration * 1000000u;
+    uint64_t measureFrom = 0;
+    Counters atMeasure = { 0 };
+    struct epoll_event events[EVENT_BATCH];
+    uint8_t buffer[NET_MAX_PACKET];
+
+    while (running)
+    {
+        int count = epoll_wait(epoll, events, EVENT_BATCH, 100);
+        uint64_t now = NowMicros();
+        if (now >= end) break;
+
+        for (int e = 0; e < count; e++)
+        {
+            if (events[e].data.u32 == UINT32_MAX)
+            {
+                uint64_t expirations;
+                if (read(timer, &expirations, sizeof(expirations)) < 0) continue;
+
+                for (int i = 0; i < clientCount; i++)
+                {
+                    Client *c = &clients[i];
+                    if (c->id < 0)
+                    {
+                        if (now - c->lastHelloUs >= HELLO_RETRY_MS * 1000u) SendHello(c, now);
+                        continue;
+                    }
+                    if (now >= c->nextSendUs)
+                    {
+                        SendState(c, now, worldWidth);
+                        c->nextSendUs += statePeriod;
+                    }
+                    if (chatEvery > 0 && now >= c->nextChatUs)
+                    {
+                        SendChat(c, now);
+                        c->nextChatUs += (uint64_t)chatEvery * 1000000u;
+                    }
+                }
+                continue;
+            }
+
+            Client *c = &clients[events[e].data.u32];
+            for (;;)
+            {
+                ssize_t size = recv(c->sock, buffer, sizeof(buffer), 0);
+                if (size < 0) break;
+                counters.packetsIn++;
+                counters.bytesIn += (uint64_t)size;
+                HandlePacket(c, buffer, (int)size, now);
+            }
+        }
+
+        // Throughput counts from the moment everyone is connected
+        if (!measureFrom)
+        {
+            int connected = 0;
+            for (int i = 0; i < clientCount; i++) connected += clients[i].id >= 0;
+            if (connected == clientCount)
+            {
+                measureFrom = now;
+                atMeasure = counters;
+            }
+        }
+    }
+
+    uint64_t stop = NowMicros();
+    int connected = 0;
+    for (int i = 0; i < clientCount; i++) connected += clients[i].id >= 0;
+
+    double seconds = measureFrom ? (stop - measureFrom) / 1e6 : (stop - start) / 1e6;
+    Counters base = measureFrom ? atMeasure : (Counters){ 0 };
+    printf("clients %i/%i connected, %.1f s measured, %.1f per 480-wide screen\n",
+           connected, clientCount, seconds, clientCount * 480.0f / worldWidth);
+    printf("sent     %10.0f pkt/s %8.2f MB/s\n",
+           (counters.packetsOut - base.packetsOut) / seconds, (counters.bytesOut - base.bytesOut) / seconds / 1e6);
+    printf("received %10.0f pkt/s %8.2f MB/s (%.0f entities/s, %.0f chat lines/s)\n",
+           (counters.packetsIn - base.packetsIn) / seconds, (counters.bytesIn - base.bytesIn) / seconds / 1e6,
+           (counters.entities - base.entities) / seconds, (counters.chats - base.chats) / seconds);
+    uint64_t snapshots = counters.snapshots - base.snapshots;
+    printf("per client received %.2f KB/s, %.1f entities per snapshot (%.2f leaves)\n",
+           (counters.bytesIn - base.bytesIn) / seconds / 1e3 / clientCount,
+           snapshots ? (double)(counters.entities - base.entities) / snapshots : 0.0,
+           snapshots ? (double)(counters.leaves - base.leaves) / snapshots : 0.0);
+    PrintLatency("state", &stateLatency);
+    PrintLatency("chat", &chatLatency);
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        // Let the server free the slots now instead of after the timeout
+        uint8_t bye[NET_HEADER_SIZE];
+        NetWriter w = Net_Writer(bye, sizeof(bye));
+        Net_WriteHeader(&w, NET_MSG_BYE);
+        Send(&clients[i], &w);
+        close(clients[i].sock);
+    }
+    close(timer);
+    close(epoll);
+    free(clients);
+    return 0;
+}
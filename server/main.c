@@ -0,0 +1,109 @@
+// UMG relay server: relays chat lines and player state between game clients.
+//
+//   umg_server [-p port] [-c max clients] [-t tick rate] [-w world width]
+#include "relay.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STATS_INTERVAL_S 5
+
+static volatile sig_atomic_t running = 1;
+
+static void OnSignal(int sig)
+{
+    (void)sig;
+    running = 0;
+}
+
+static double NowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void PrintStats(const Relay *relay, const RelayStats *last, double seconds)
+{
+    const RelayStats *s = &relay->stats;
+    double bytesOut = (s->bytesOut - last->bytesOut) / seconds;
+    double perClient = relay->clientCount > 0 ? bytesOut / relay->clientCount : 0.0;
+    uint64_t ticks = s->ticks - last->ticks;
+    double tickMicros = ticks ? (double)(s->tickMicros - last->tickMicros) / ticks : 0.0;
+    double tickCpuMicros = ticks ? (double)(s->tickCpuMicros - last->tickCpuMicros) / ticks : 0.0;
+    printf("clients %5i | in %8.0f pkt/s %7.2f MB/s | out %8.0f pkt/s %7.2f MB/s, %6.2f KB/s per client | "
+           "view %5.1f | drops %llu | tick %.0f us, %.0f us cpu (max %u)\n",
+           relay->clientCount,
+           (s->packetsIn - last->packetsIn) / seconds, (s->bytesIn - last->bytesIn) / seconds / 1e6,
+           (s->packetsOut - last->packetsOut) / seconds, bytesOut / 1e6, perClient / 1e3,
+           s->lastViewers ? (double)s->lastVisible / s->lastViewers : 0.0,
+           (unsigned long long)(s->sendDrops + s->chatDrops), tickMicros, tickCpuMicros, s->maxTickMicros);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    int port = NET_DEFAULT_PORT;
+    int capacity = 4096;
+    int tickRate = NET_TICK_RATE;
+    float worldWidth = 4000.0f; // The meadow level
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:c:t:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p': port = atoi(optarg); break;
+            case 'c': capacity = atoi(optarg); break;
+            case 't': tickRate = atoi(optarg); break;
+            case 'w': worldWidth = (float)atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-p port] [-c max clients] [-t tick rate] [-w world width]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    // The relay carries its batch buffers inline, too big for the stack
+    static Relay relay;
+    if (!Relay_Init(&relay, port, capacity, tickRate, worldWidth))
+    {
+        perror("umg_server: failed to start");
+        return 1;
+    }
+
+    struct sigaction sa = { 0 };
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("umg_server: port %i, %i slots, %i Hz, world %.0f wide\n", port, capacity, tickRate, worldWidth);
+
+    RelayStats last = relay.stats;
+    double lastPrint = NowSeconds();
+    while (running)
+    {
+        if (!Relay_Poll(&relay, 100))
+        {
+            perror("umg_server: poll failed");
+            break;
+        }
+
+        double now = NowSeconds();
+        if (now - lastPrint >= STATS_INTERVAL_S)
+        {
+            PrintStats(&relay, &last, now - lastPrint);
+            last = relay.stats;
+            relay.stats.maxTickMicros = 0;
+            lastPrint = now;
+        }
+    }
+
+    printf("umg_server: %u timeouts, %u rejected, %llu send drops, %llu chat drops\n",
+           relay.stats.timeouts, relay.stats.rejected,
+           (unsigned long long)relay.stats.sendDrops, (unsigned long long)relay.stats.chatDrops);
+    Relay_Shutdown(&relay);
+    return 0;
+}
@@ -0,0 +1,497 @@
+#include "relay.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t NowMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* =============================
+   ADDRESS LOOKUP
+============================= */
+static uint64_t AddressKey(const struct sockaddr_in *addr)
+{
+    return ((uint64_t)addr->sin_addr.s_addr << 16) | addr->sin_port;
+}
+
+static uint32_t Hash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static int FindClient(const Relay *relay, uint64_t key)
+{
+    for (uint32_t i = Hash(key) & relay->lookupMask;; i = (i + 1) & relay->lookupMask)
+    {
+        if (relay->lookup[i] < 0) return -1;
+        if (relay->lookupKeys[i] == key) return relay->lookup[i];
+    }
+}
+
+static void InsertClient(Relay *relay, uint64_t key, int slot)
+{
+    uint32_t i = Hash(key) & relay->lookupMask;
+    while (relay->lookup[i] >= 0) i = (i + 1) & relay->lookupMask;
+    relay->lookup[i] = slot;
+    relay->lookupKeys[i] = key;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void EraseClient(Relay *relay, uint64_t key)
+{
+    uint32_t i = Hash(key) & relay->lookupMask;
+    while (relay->lookupKeys[i] != key || relay->lookup[i] < 0)
+    {
+        if (relay->lookup[i] < 0) return;
+        i = (i + 1) & relay->lookupMask;
+    }
+
+    for (uint32_t j = (i + 1) & relay->lookupMask; relay->lookup[j] >= 0; j = (j + 1) & relay->lookupMask)
+    {
+        uint32_t home = Hash(relay->lookupKeys[j]) & relay->lookupMask;
+        // Move j back into the hole unless its home lies cyclically in (i, j]
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+
+        relay->lookup[i] = relay->lookup[j];
+        relay->lookupKeys[i] = relay->lookupKeys[j];
+        i = j;
+    }
+    relay->lookup[i] = -1;
+}
+
+/* =============================
+   SENDING
+============================= */
+static void Flush(Relay *relay)
+{
+    int offset = 0;
+    while (offset < relay->sendCount)
+    {
+        int sent = sendmmsg(relay->sock, relay->sendMsgs + offset, (unsigned)(relay->sendCount - offset), 0);
+        if (sent < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                // This datagram alone is bad (e.g. unroutable), skip past it
+                relay->stats.sendDrops++;
+                offset++;
+                continue;
+            }
+            // Socket buffer full: UDP state is superseded next tick, so drop
+            relay->stats.sendDrops += (uint64_t)(relay->sendCount - offset);
+            break;
+        }
+        for (int i = offset; i < offset + sent; i++) relay->stats.bytesOut += relay->sendMsgs[i].msg_len;
+        relay->stats.packetsOut += (uint64_t)sent;
+        offset += sent;
+    }
+    relay->sendCount = 0;
+}
+
+// Queues one datagram. data must stay valid until the next Flush.
+static void Queue(Relay *relay, const struct sockaddr_in *to, const void *data, int size)
+{
+    if (relay->sendCount == RELAY_SEND_BATCH) Flush(relay);
+
+    int n = relay->sendCount++;
+    relay->sendIov[n] = (struct iovec){ (void *)data, (size_t)size };
+
+    struct msghdr *msg = &relay->sendMsgs[n].msg_hdr;
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_name = (void *)to;
+    msg->msg_namelen = sizeof(*to);
+    msg->msg_iov = &relay->sendIov[n];
+    msg->msg_iovlen = 1;
+}
+
+/* =============================
+   CLIENTS
+============================= */
+static int AddClient(Relay *relay, const struct sockaddr_in *addr, uint64_t nowMs)
+{
+    if (relay->freeCount == 0)
+    {
+        relay->stats.rejected++;
+        return -1;
+    }
+
+    int slot = relay->freeSlots[--relay->freeCount];
+    RelayClient *c = &relay->clients[slot];
+    memset(c, 0, sizeof(RelayClient));
+    c->active = true;
+    c->addr = *addr;
+    c->lastHeardMs = nowMs;
+
+    InsertClient(relay, AddressKey(addr), slot);
+    relay->clientCount++;
+    return slot;
+}
+
+static void RemoveClient(Relay *relay, int slot)
+{
+    RelayClient *c = &relay->clients[slot];
+    EraseClient(relay, AddressKey(&c->addr));
+    Aoi_Remove(&relay->aoi, slot);
+    c->active = false;
+    relay->freeSlots[relay->freeCount++] = slot;
+    relay->clientCount--;
+}
+
+static void HandlePacket(Relay *relay, const uint8_t *data, int size, const struct sockaddr_in *from,
+                         uint64_t nowMs, int replyIndex)
+{
+    NetReader r = Net_Reader(data, size);
+    int type = Net_ReadHeader(&r);
+    if (!type) return;
+
+    uint64_t key = AddressKey(from);
+    int slot = FindClient(relay, key);
+
+    if (type == NET_MSG_HELLO)
+    {
+        if (slot < 0) slot = AddClient(relay, from, nowMs);
+        if (slot < 0) return;
+
+        // Resent on every HELLO in case the previous WELCOME was lost
+        NetWriter w = Net_Writer(relay->replies[replyIndex], sizeof(relay->replies[replyIndex]));
+        Net_WriteHeader(&w, NET_MSG_WELCOME);
+        Net_WriteU16(&w, (uint16_t)slot);
+        Net_WriteU16(&w, (uint16_t)relay->tickRate);
+        Queue(relay, &relay->clients[slot].addr, w.data, w.size);
+        return;
+    }
+
+    if (slot < 0) return; // Traffic from strangers is ignored until they say HELLO
+    RelayClient *c = &relay->clients[slot];
+    c->lastHeardMs = nowMs;
+
+    switch (type)
+    {
+        case NET_MSG_STATE:
+        {
+            uint32_t clientTime = Net_ReadU32(&r);
+            float x = Net_ReadF32(&r);
+            float y = Net_ReadF32(&r);
+            int8_t facing = (int8_t)Net_ReadU8(&r);
+            uint8_t flags = Net_ReadU8(&r);
+            if (r.overflow) return;
+
+            c->echoTime = clientTime;
+            c->x = x;
+            c->y = y;
+            c->facing = facing;
+            c->flags = flags;
+            c->hasState = true;
+            Aoi_SetPosition(&relay->aoi, slot, x);
+            break;
+        }
+        case NET_MSG_CHAT:
+        {
+            uint32_t clientTime = Net_ReadU32(&r);
+            int length = Net_ReadU8(&r);
+            if (r.overflow || length > NET_MAX_CHAT || r.offset + length > r.size) return;
+
+            if (relay->chatCount == RELAY_MAX_CHATS)
+            {
+                relay->stats.chatDrops++;
+                return;
+            }
+
+            int n = relay->chatCount++;
+            NetWriter w = Net_Writer(relay->chats[n], NET_MAX_PACKET);
+            Net_WriteHeader(&w, NET_MSG_CHAT_RELAY);
+            Net_WriteU16(&w, (uint16_t)slot);
+            Net_WriteU32(&w, clientTime);
+            Net_WriteU8(&w, (uint8_t)length);
+            Net_WriteBytes(&w, r.data + r.offset, length);
+            relay->chatSizes[n] = w.size;
+            relay->chatSenders[n] = slot;
+            break;
+        }
+        case NET_MSG_BYE:
+            RemoveClient(relay, slot);
+            break;
+        default:
+            break;
+    }
+}
+
+static bool Receive(Relay *relay)
+{
+    for (;;)
+    {
+        for (int i = 0; i < RELAY_RECV_BATCH; i++)
+        {
+            relay->recvIov[i] = (struct iovec){ relay->recvData[i], NET_MAX_PACKET };
+            struct msghdr *msg = &relay->recvMsgs[i].msg_hdr;
+            memset(msg, 0, sizeof(*msg));
+            msg->msg_name = &relay->recvAddrs[i];
+            msg->msg_namelen = sizeof(relay->recvAddrs[i]);
+            msg->msg_iov = &relay->recvIov[i];
+            msg->msg_iovlen = 1;
+        }
+
+        int count = recvmmsg(relay->sock, relay->recvMsgs, RELAY_RECV_BATCH, MSG_DONTWAIT, NULL);
+        if (count < 0)
+        {
+            // Flush sends, which can overwrite errno
+            int error = errno;
+            if (error == EINTR) continue;
+            Flush(relay);
+            return error == EAGAIN || error == EWOULDBLOCK;
+        }
+
+        uint64_t nowMs = NowMicros() / 1000u;
+        for (int i = 0; i < count; i++)
+        {
+            relay->stats.packetsIn++;
+            relay->stats.bytesIn += relay->recvMsgs[i].msg_len;
+            HandlePacket(relay, relay->recvData[i], (int)relay->recvMsgs[i].msg_len,
+                         &relay->recvAddrs[i], nowMs, i);
+        }
+
+        // WELCOMEs point into replies[], which the next batch reuses
+        Flush(relay);
+        if (count < RELAY_RECV_BATCH) return true;
+    }
+}
+
+/* =============================
+   TICK
+============================= */
+static void WriteEntity(NetWriter *w, int slot, const RelayClient *c, uint8_t flags)
+{
+    Net_WriteU16(w, (uint16_t)slot);
+    Net_WriteF32(w, c->x);
+    Net_WriteF32(w, c->y);
+    Net_WriteU8(w, (uint8_t)c->facing);
+    Net_WriteU8(w, flags);
+}
+
+// Each client hears only about players near its camera, so the cost per
+// client is bounded by AOI_MAX_VISIBLE instead of growing with the server
+static void SendSnapshot(Relay *relay, int slot, const AoiUpdate *update)
+{
+    RelayClient *c = &relay->clients[slot];
+
+    NetWriter w = Net_Writer(c->snapshot, NET_MAX_PACKET);
+    Net_WriteHeader(&w, NET_MSG_SNAPSHOT);
+    Net_WriteU32(&w, relay->tick);
+    Net_WriteU32(&w, c->echoTime);
+    Net_WriteU16(&w, 0);
+
+    int count = 0;
+    for (int i = 0; i < update->sendCount; i++, count++)
+    {
+        int other = update->send[i];
+        WriteEntity(&w, other, &relay->clients[other], relay->clients[other].flags);
+    }
+    // Leave notices fill whatever room is left, oldest first; the rest stay
+    // queued in the view for the next tick
+    int leaves = c->view.leavingCount;
+    if (leaves > RELAY_ENTITIES_PER_PACKET - count) leaves = RELAY_ENTITIES_PER_PACKET - count;
+    for (int i = 0; i < leaves; i++, count++)
+    {
+        int other = c->view.leaving[i];
+        WriteEntity(&w, other, &relay->clients[other], NET_FLAG_LEFT);
+    }
+    Aoi_DropLeaves(&c->view, leaves);
+
+    w.data[NET_SNAPSHOT_HEADER_SIZE] = (uint8_t)count;
+    w.data[NET_SNAPSHOT_HEADER_SIZE + 1] = (uint8_t)(count >> 8);
+    Queue(relay, &c->addr, w.data, w.size);
+
+    relay->stats.entitiesOut += (uint64_t)count;
+    relay->stats.leavesOut += (uint64_t)leaves;
+}
+
+static uint64_t ThreadCpuMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void Tick(Relay *relay)
+{
+    uint64_t start = NowMicros();
+    uint64_t cpuStart = ThreadCpuMicros();
+    uint64_t nowMs = start / 1000u;
+    relay->tick++;
+
+    for (int slot = 0; slot < relay->capacity; slot++)
+    {
+        if (!relay->clients[slot].active) continue;
+        if (nowMs - relay->clients[slot].lastHeardMs > NET_CLIENT_TIMEOUT_MS)
+        {
+            RemoveClient(relay, slot);
+            relay->stats.timeouts++;
+        }
+    }
+
+    Aoi_Build(&relay->aoi);
+
+    uint32_t viewers = 0, visible = 0;
+    for (int slot = 0; slot < relay->capacity; slot++)
+    {
+        RelayClient *c = &relay->clients[slot];
+        if (!c->active || !c->hasState) continue; // Nowhere to look from yet
+
+        AoiUpdate update;
+        Aoi_Update(&relay->aoi, &c->view, slot, c->x, relay->tick, &update);
+        SendSnapshot(relay, slot, &update);
+        viewers++;
+        visible += (uint32_t)c->view.visibleCount;
+
+        // Chat shows as a bubble over the speaker, so it follows the same view.
+        // Speakers get their own line back as a delivery receipt.
+        for (int i = 0; i < relay->chatCount; i++)
+        {
+            int sender = relay->chatSenders[i];
+            if (sender == slot || Aoi_InView(&relay->aoi, sender))
+                Queue(relay, &c->addr, relay->chats[i], relay->chatSizes[i]);
+        }
+    }
+    Flush(relay);
+    relay->chatCount = 0;
+    relay->stats.lastViewers = viewers;
+    relay->stats.lastVisible = visible;
+
+    uint32_t micros = (uint32_t)(NowMicros() - start);
+    relay->stats.ticks++;
+    relay->stats.tickMicros += micros;
+    relay->stats.tickCpuMicros += ThreadCpuMicros() - cpuStart;
+    if (micros > relay->stats.maxTickMicros) relay->stats.maxTickMicros = micros;
+}
+
+/* =============================
+   SETUP / LOOP
+============================= */
+bool Relay_Init(Relay *relay, int port, int capacity, int tickRate, float worldWidth)
+{
+    memset(relay, 0, sizeof(Relay));
+    relay->sock = relay->epoll = relay->timer = -1;
+    if (capacity <= 0 || capacity > 65535 || tickRate <= 0) return false;
+
+    relay->capacity = capacity;
+    relay->tickRate = tickRate;
+
+    uint32_t lookupSize = 1;
+    while (lookupSize < (uint32_t)capacity * 2) lookupSize <<= 1;
+    relay->lookupMask = lookupSize - 1;
+
+    relay->clients = calloc((size_t)capacity, sizeof(RelayClient));
+    relay->freeSlots = malloc(sizeof(int) * (size_t)capacity);
+    relay->lookup = malloc(sizeof(int32_t) * lookupSize);
+    relay->lookupKeys = calloc(lookupSize, sizeof(uint64_t));
+    bool aoi = Aoi_Init(&relay->aoi, capacity, worldWidth);
+    if (!relay->clients || !relay->freeSlots || !relay->lookup || !relay->lookupKeys || !aoi)
+    {
+        Relay_Shutdown(relay);
+        return false;
+    }
+
+    // Hand out low ids first
+    for (int i = 0; i < capacity; i++) relay->freeSlots[i] = capacity - 1 - i;
+    relay->freeCount = capacity;
+    for (uint32_t i = 0; i < lookupSize; i++) relay->lookup[i] = -1;
+
+    relay->sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (relay->sock < 0)
+    {
+        Relay_Shutdown(relay);
+        return false;
+    }
+
+    // A tick bursts a snapshot to every client at once; give the kernel room for it
+    int bufferBytes = 8 * 1024 * 1024;
+    setsockopt(relay->sock, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+    setsockopt(relay->sock, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(relay->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        Relay_Shutdown(relay);
+        return false;
+    }
+
+    relay->timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    relay->epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (relay->timer < 0 || relay->epoll < 0)
+    {
+        Relay_Shutdown(relay);
+        return false;
+    }
+
+    long periodNs = 1000000000L / tickRate;
+    struct itimerspec period = { { periodNs / 1000000000L, periodNs % 1000000000L },
+                                 { periodNs / 1000000000L, periodNs % 1000000000L } };
+    struct epoll_event sockEvent = { 0 }, timerEvent = { 0 };
+    sockEvent.events = timerEvent.events = EPOLLIN;
+    sockEvent.data.fd = relay->sock;
+    timerEvent.data.fd = relay->timer;
+
+    // Without the timer or either registration the loop would never tick
+    if (timerfd_settime(relay->timer, 0, &period, NULL) != 0 ||
+        epoll_ctl(relay->epoll, EPOLL_CTL_ADD, relay->sock, &sockEvent) != 0 ||
+        epoll_ctl(relay->epoll, EPOLL_CTL_ADD, relay->timer, &timerEvent) != 0)
+    {
+        Relay_Shutdown(relay);
+        return false;
+    }
+    return true;
+}
+
+void Relay_Shutdown(Relay *relay)
+{
+    if (relay->sock >= 0) close(relay->sock);
+    if (relay->epoll >= 0) close(relay->epoll);
+    if (relay->timer >= 0) close(relay->timer);
+    free(relay->clients);
+    free(relay->freeSlots);
+    free(relay->lookup);
+    free(relay->lookupKeys);
+    Aoi_Free(&relay->aoi);
+    memset(relay, 0, sizeof(Relay));
+    relay->sock = relay->epoll = relay->timer = -1;
+}
+
+bool Relay_Poll(Relay *relay, int timeoutMs)
+{
+    struct epoll_event events[2];
+    int count = epoll_wait(relay->epoll, events, 2, timeoutMs);
+    if (count < 0) return errno == EINTR;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (events[i].data.fd == relay->sock)
+        {
+            if (!Receive(relay)) return false;
+        }
+        else if (events[i].data.fd == relay->timer)
+        {
+            uint64_t expirations;
+            if (read(relay->timer, &expirations, sizeof(expirations)) != sizeof(expirations)) continue;
+            // A late wakeup runs one tick, not a burst of catch-up ticks
+            Tick(relay);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef RELAY_H
+#define RELAY_H
+
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include "aoi.h"
+#include "netproto.h"
+
+#define RELAY_RECV_BATCH  64
+#define RELAY_SEND_BATCH  512
+#define RELAY_MAX_CHATS   64 // Chat lines relayed per tick, extras are dropped
+#define RELAY_ENTITIES_PER_PACKET ((NET_MAX_PACKET - NET_SNAPSHOT_HEADER_SIZE - 2) / NET_ENTITY_SIZE)
+
+#if AOI_MAX_VISIBLE > RELAY_ENTITIES_PER_PACKET
+#error "A full view must fit in one snapshot packet"
+#endif
+
+typedef struct RelayStats {
+    uint64_t packetsIn, bytesIn;
+    uint64_t packetsOut, bytesOut;
+    uint64_t sendDrops;    // Datagrams the kernel would not take (EAGAIN)
+    uint64_t chatDrops;    // Chat lines beyond RELAY_MAX_CHATS in one tick
+    uint64_t entitiesOut;  // Entity updates sent, summed over clients
+    uint64_t leavesOut;    // NET_FLAG_LEFT notices among them
+    uint32_t rejected;     // HELLOs refused because every slot was taken
+    uint32_t timeouts;
+    uint32_t lastViewers;  // Clients that got a snapshot last tick
+    uint32_t lastVisible;  // Sum of their view sizes
+    uint64_t ticks;
+    uint64_t tickMicros;    // Wall time summed over ticks
+    uint64_t tickCpuMicros; // Time the tick actually ran, sends included; the
+                            // gap to wall time is the machine being busy elsewhere
+    uint32_t maxTickMicros;
+} RelayStats;
+
+// One slot per client, allocated up front. The slot index is the player id.
+typedef struct RelayClient {
+    bool active;
+    bool hasState;
+    struct sockaddr_in addr;
+    uint64_t lastHeardMs;
+
+    float x, y;
+    int8_t facing;
+    uint8_t flags;
+    uint32_t echoTime; // Last clientTime received, returned in every snapshot
+
+    AoiView view;
+    uint8_t snapshot[NET_MAX_PACKET]; // Stays untouched until the tick's sends are flushed
+} RelayClient;
+
+typedef struct Relay {
+    int sock;
+    int epoll;
+    int timer;
+    int tickRate;
+    uint32_t tick;
+
+    RelayClient *clients;
+    int capacity;
+    int clientCount;
+    int *freeSlots; // Stack of unused slot indices
+    int freeCount;
+
+    // Open-addressed map from client address to slot, linear probing
+    int32_t *lookup;
+    uint64_t *lookupKeys;
+    uint32_t lookupMask;
+
+    AoiGrid aoi;
+
+    uint8_t chats[RELAY_MAX_CHATS][NET_MAX_PACKET];
+    int chatSizes[RELAY_MAX_CHATS];
+    int chatSenders[RELAY_MAX_CHATS];
+    int chatCount;
+
+    uint8_t recvData[RELAY_RECV_BATCH][NET_MAX_PACKET];
+    struct sockaddr_in recvAddrs[RELAY_RECV_BATCH];
+    struct iovec recvIov[RELAY_RECV_BATCH];
+    struct mmsghdr recvMsgs[RELAY_RECV_BATCH];
+
+    struct iovec sendIov[RELAY_SEND_BATCH];
+    struct mmsghdr sendMsgs[RELAY_SEND_BATCH];
+    uint8_t replies[RELAY_RECV_BATCH][16]; // WELCOMEs sent from the receive path
+    int sendCount;
+
+    RelayStats stats;
+} Relay;
+
+// Binds a non-blocking UDP socket on port and arms the tick timer.
+// worldWidth lets area-of-interest culling clamp cameras like the game does.
+bool Relay_Init(Relay *relay, int port, int capacity, int tickRate, float worldWidth);
+void Relay_Shutdown(Relay *relay);
+
+// Waits up to timeoutMs for traffic or the tick timer and handles it.
+// Returns false on a fatal error.
+bool Relay_Poll(Relay *relay, int timeoutMs);
+
+#endif
@@ -0,0 +1,154 @@
+// Broadphase throughput against collider count. Levels of growing size are
+// generated two ways: "wide" keeps the density of a real level and stretches
+// the world, "dense" packs more boxes into the same 4000px world. Each reports
+// Collision_Query and Collision_Move calls per second through the real
+// collision.c, next to a brute-force scan over every box.
+//
+// Build from the repository root:
+//   cc -std=c99 -O2 -Iapp/src/main/cpp -o collbench tools/collbench.c
+//      app/src/main/cpp/collision.c -lm
+//
+// Usage:
+//   collbench [cellSize]   grid cell size, 128 (the game's) by default
+#define _POSIX_C_SOURCE 200809L
+#include "collision.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SCREEN_WIDTH   480
+#define SCREEN_HEIGHT  360
+#define GROUND_Y       300
+#define DENSE_WIDTH    4000
+#define BOXES_PER_1000 12      // About what the meadow level has
+#define PLAYER_WIDTH   18
+#define PLAYER_HEIGHT  46
+#define QUERIES        200000
+#define MAX_BOXES      (1 << 20)
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static CollisionBox boxes[MAX_BOXES];
+static int results[MAX_BOXES];
+static float probeX[QUERIES];
+static float probeY[QUERIES];
+
+static float RandomRange(float min, float max)
+{
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+// Ground plus platforms, steps and slopes scattered over the world
+static void Generate(int count, float worldWidth)
+{
+    boxes[0] = (CollisionBox){ 0, GROUND_Y, worldWidth, 40, COLLISION_SOLID };
+    for (int i = 1; i < count; i++)
+    {
+        float x = RandomRange(0.0f, worldWidth - 120.0f);
+        switch (rand() % 4)
+        {
+            case 0: boxes[i] = (CollisionBox){ x, RandomRange(120, 260), RandomRange(40, 120), 8, COLLISION_ONE_WAY }; break;
+            case 1: boxes[i] = (CollisionBox){ x, RandomRange(220, 280), RandomRange(20, 60), 40, COLLISION_SOLID }; break;
+            case 2: boxes[i] = (CollisionBox){ x, 260, 80, 40, COLLISION_SLOPE_UP }; break;
+            default: boxes[i] = (CollisionBox){ x, 260, 80, 40, COLLISION_SLOPE_DOWN }; break;
+        }
+    }
+
+    for (int q = 0; q < QUERIES; q++)
+    {
+        probeX[q] = RandomRange(0.0f, worldWidth - PLAYER_WIDTH);
+        probeY[q] = RandomRange(100.0f, GROUND_Y - PLAYER_HEIGHT);
+    }
+}
+
+// Calls per second of one kind of query; *hits keeps the work observable
+static double TimeQueries(const CollisionWorld *world, float width, float height, long *hits)
+{
+    double start = Now();
+    for (int q = 0; q < QUERIES; q++)
+        *hits += Collision_Query(world, probeX[q], probeY[q], width, height, results, MAX_BOXES);
+    return QUERIES / (Now() - start);
+}
+
+static double TimeMoves(const CollisionWorld *world, long *hits)
+{
+    double start = Now();
+    for (int q = 0; q < QUERIES; q++)
+    {
+        CollisionBox body = { probeX[q], probeY[q], PLAYER_WIDTH, PLAYER_HEIGHT, COLLISION_SOLID };
+        CollisionMove move;
+        Collision_Move(world, &body, (q & 1) ? 4.0f : -4.0f, 6.0f, true, &move);
+        *hits += move.landed;
+    }
+    return QUERIES / (Now() - start);
+}
+
+// The same player-sized query without a broadphase, on fewer probes since it is O(n)
+static double TimeBruteForce(int count, long *hits)
+{
+    int queries = QUERIES / (count / 256 + 1);
+    double start = Now();
+    for (int q = 0; q < queries; q++)
+    {
+        float x = probeX[q], y = probeY[q];
+        for (int i = 0; i < count; i++)
+        {
+            const CollisionBox *b = &boxes[i];
+            if (b->x > x + PLAYER_WIDTH || b->x + b->width < x ||
+                b->y > y + PLAYER_HEIGHT || b->y + b->height < y) continue;
+            (*hits)++;
+        }
+    }
+    return queries / (Now() - start);
+}
+
+static void Run(const char *name, bool wide, int maxCount, float cellSize)
+{
+    printf("%s\n%9s %9s %13s %13s %13s %13s\n", name, "boxes", "width",
+           "player q/s", "screen q/s", "move/s", "brute q/s");
+
+    long hits = 0;
+    for (int count = 64; count <= maxCount; count *= 4)
+    {
+        float worldWidth = wide ? count * 1000.0f / BOXES_PER_1000 : DENSE_WIDTH;
+        srand(1);
+        Generate(count, worldWidth);
+
+        CollisionWorld world;
+        if (!Collision_Build(&world, boxes, count, cellSize))
+        {
+            fprintf(stderr, "out of memory building %i boxes\n", count);
+            return;
+        }
+
+        double player = TimeQueries(&world, PLAYER_WIDTH, PLAYER_HEIGHT, &hits);
+        double screen = TimeQueries(&world, SCREEN_WIDTH, SCREEN_HEIGHT, &hits);
+        double moves = TimeMoves(&world, &hits);
+        double brute = TimeBruteForce(count, &hits);
+        printf("%9i %9.0f %13.0f %13.0f %13.0f %13.0f\n", count, worldWidth, player, screen, moves, brute);
+        Collision_Free(&world);
+    }
+    printf("(%ld hits)\n\n", hits);
+}
+
+int main(int argc, char **argv)
+{
+    float cellSize = argc > 1 ? (float)atof(argv[1]) : 128.0f;
+    if (cellSize <= 0.0f)
+    {
+        fprintf(stderr, "usage: collbench [cellSize]\n");
+        return 1;
+    }
+
+    Run("wide (constant density)", true, MAX_BOXES, cellSize);
+
+    // Past this a screen query returns thousands of boxes and just measures the copy
+    Run("dense (4000px world)", false, 16384, cellSize);
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Serial vs parallel timing for the job system on the game's two data-parallel
+// workloads: the per-frame bird update and the ground texture bake. The
+// kernels mirror UpdateBirdRange and BakeGroundRows in main.c, which sit
+// behind raylib there, and run through the real jobs.c.
+//
+// Build from the repository root:
+//   cc -std=c99 -O2 -Iapp/src/main/cpp -o jobsbench tools/jobsbench.c
+//      app/src/main/cpp/jobs.c -lm -lpthread
+//
+// Usage:
+//   jobsbench [workers]   0 (default) picks one per core minus the caller
+#define _POSIX_C_SOURCE 200809L
+#include "jobs.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCREEN_WIDTH       480
+#define GROUND_WIDTH       4000
+#define GROUND_HEIGHT      200
+#define GROUND_PEBBLES     400
+#define GROUND_GRAIN       8
+#define MAX_BIRDS          65536
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* =============================
+   BIRDS
+============================= */
+typedef struct { float x, y, speed, phase; } Bird;
+
+static Bird birds[MAX_BIRDS];
+
+static void UpdateBirdRange(void *data, int begin, int end)
+{
+    float time = *(const float *)data;
+    for (int i = begin; i < end; i++)
+    {
+        birds[i].x += birds[i].speed;
+        birds[i].y += sinf(time * 1.2f + birds[i].phase) * 0.3f;
+        if (birds[i].x > SCREEN_WIDTH + 80) birds[i].x = -100;
+    }
+}
+
+// Microseconds per update of count birds, averaged over enough frames to be stable
+static double TimeBirds(int count, int grain)
+{
+    int frames = 2000000 / count + 50;
+    float time = 0.0f;
+    double start = Now();
+    for (int f = 0; f < frames; f++, time += 1.0f / 60.0f)
+    {
+        if (grain <= 0)
+        {
+            UpdateBirdRange(&time, 0, count);
+            continue;
+        }
+        JobCounter counter = {0};
+        Jobs_ParallelFor(UpdateBirdRange, &time, count, grain, &counter);
+        Jobs_Wait(&counter);
+    }
+    return (Now() - start) * 1e6 / frames;
+}
+
+/* =============================
+   GROUND
+============================= */
+typedef struct { unsigned char r, g, b, a; } Rgba;
+typedef struct { int x, y, radius; } Pebble;
+
+static Rgba pixels[GROUND_WIDTH * GROUND_HEIGHT];
+static int columnTop[GROUND_WIDTH / 4 + 1];
+static Pebble pebbles[GROUND_PEBBLES];
+
+static Rgba BlendOver(Rgba dst, Rgba src, float alpha)
+{
+    return (Rgba){
+        (unsigned char)(src.r * alpha + dst.r * (1.0f - alpha)),
+        (unsigned char)(src.g * alpha + dst.g * (1.0f - alpha)),
+        (unsigned char)(src.b * alpha + dst.b * (1.0f - alpha)),
+        255
+    };
+}
+
+static void BakeGroundRows(void *data, int begin, int end)
+{
+    (void)data;
+    const Rgba dirt = { 76, 63, 47, 255 }, brown = { 127, 106, 79, 255 }, gray = { 80, 80, 80, 255 };
+    for (int y = begin; y < end; y++)
+    {
+        Rgba *row = pixels + (GROUND_HEIGHT - 1 - y) * GROUND_WIDTH;
+        for (int x = 0; x < GROUND_WIDTH; x++)
+            row[x] = (y >= columnTop[x / 4]) ? BlendOver(dirt, brown, 0.75f) : dirt;
+
+        for (int i = 0; i < GROUND_PEBBLES; i++)
+        {
+            const Pebble *p = &pebbles[i];
+            int dy = y - p->y;
+            if (dy < -p->radius || dy > p->radius) continue;
+
+            int span = (int)sqrtf((float)(p->radius * p->radius - dy * dy));
+            int x0 = (p->x - span < 0) ? 0 : p->x - span;
+            int x1 = (p->x + span >= GROUND_WIDTH) ? GROUND_WIDTH - 1 : p->x + span;
+            for (int x = x0; x <= x1; x++) row[x] = BlendOver(row[x], gray, 0.35f);
+        }
+    }
+}
+
+static double TimeGround(bool parallel)
+{
+    const int reps = 20;
+    double start = Now();
+    for (int r = 0; r < reps; r++)
+    {
+        if (!parallel)
+        {
+            BakeGroundRows(NULL, 0, GROUND_HEIGHT);
+            continue;
+        }
+        JobCounter counter = {0};
+        Jobs_ParallelFor(BakeGroundRows, NULL, GROUND_HEIGHT, GROUND_GRAIN, &counter);
+        Jobs_Wait(&counter);
+    }
+    return (Now() - start) * 1e3 / reps;
+}
+
+int main(int argc, char **argv)
+{
+    int workers = argc > 1 ? atoi(argv[1]) : 0;
+    if (!Jobs_Init(workers, JOBS_AFFINITY_NONE)) return 1;
+    int threads = Jobs_WorkerCount() + 1;
+
+    srand(1);
+    for (int i = 0; i < MAX_BIRDS; i++)
+        birds[i] = (Bird){ (float)(rand() % SCREEN_WIDTH), 100.0f + rand() % 200,
+                           0.5f + (rand() % 100) / 100.0f, (rand() % 628) / 100.0f };
+    for (int c = 0; c < GROUND_WIDTH / 4 + 1; c++)
+        columnTop[c] = (int)(40 + sinf(c * 4 * 0.03f) * 6 + cosf(c * 4 * 0.11f) * 3);
+    for (int i = 0; i < GROUND_PEBBLES; i++)
+        pebbles[i] = (Pebble){ rand() % GROUND_WIDTH, 80 + rand() % 101, 2 + rand() % 3 };
+
+    printf("%i threads\n\n", threads);
+    printf("bird update      serial us  parallel us  speedup  (grain = count / threads)\n");
+    static const int counts[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+    {
+        int count = counts[i];
+        int grain = (count + threads - 1) / threads;
+        double serial = TimeBirds(count, 0);
+        double parallel = TimeBirds(count, grain);
+        printf("%10i birds %10.2f %12.2f %8.2fx\n", count, serial, parallel, serial / parallel);
+    }
+
+    double serial = TimeGround(false);
+    double parallel = TimeGround(true);
+    printf("\nground bake %ix%i: serial %.2f ms, parallel %.2f ms, %.2fx\n",
+           GROUND_WIDTH, GROUND_HEIGHT, serial, parallel, serial / parallel);
+
+    Jobs_Shutdown();
+    return 0;
+}
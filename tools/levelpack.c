@@ -0,0 +1,335 @@
+// Host-side level packer: turns a text level description into the binary
+// .umgl file the game maps in place (see app/src/main/cpp/level.h).
+//
+// Build from the repository root:
+//   cc -std=c99 -O2 -DNDEBUG -Iapp/src/main/cpp -o levelpack
+//      tools/levelpack.c app/src/main/cpp/level.c app/src/main/cpp/collision.c -lm
+//
+// Usage:
+//   levelpack <in.txt> <out.umgl>   pack a level
+//   levelpack --bench <dir>         time opening generated levels of growing size
+//
+// Text format, one record per line, '#' starts a comment:
+//   world    <width> <groundY>
+//   spawn    <x> <y>
+//   lighting <transitionCenter> <transitionWidth> <dayAmbient> <nightAmbient>
+//   grid     <cellSize>
+//   box      <x> <y> <width> <height> solid|oneway|slopeup|slopedown
+//   star     <x> <y> <phase> <speed>
+//   bird     <x> <y> <speed> <phase>
+//   parallax triangle|circle <factor> <spacing> <y> <size> <count> <r> <g> <b> <a>
+#define _POSIX_C_SOURCE 200809L
+#include "level.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    void *items;
+    int count, capacity;
+    size_t itemSize;
+} Array;
+
+static void *Push(Array *array)
+{
+    if (array->count == array->capacity)
+    {
+        int capacity = array->capacity ? array->capacity * 2 : 64;
+        void *items = realloc(array->items, (size_t)capacity * array->itemSize);
+        if (!items)
+        {
+            fprintf(stderr, "levelpack: out of memory\n");
+            exit(1);
+        }
+        array->items = items;
+        array->capacity = capacity;
+    }
+    return (char *)array->items + (size_t)array->count++ * array->itemSize;
+}
+
+typedef struct {
+    LevelDesc desc;
+    Array boxes, stars, birds, parallax;
+} Source;
+
+static void InitSource(Source *src)
+{
+    memset(src, 0, sizeof(Source));
+    src->boxes.itemSize = sizeof(CollisionBox);
+    src->stars.itemSize = sizeof(LevelStar);
+    src->birds.itemSize = sizeof(LevelBird);
+    src->parallax.itemSize = sizeof(LevelParallax);
+    src->desc.cellSize = 128.0f;
+}
+
+static void FinishSource(Source *src)
+{
+    src->desc.boxes = src->boxes.items;
+    src->desc.boxCount = src->boxes.count;
+    src->desc.stars = src->stars.items;
+    src->desc.starCount = src->stars.count;
+    src->desc.birds = src->birds.items;
+    src->desc.birdCount = src->birds.count;
+    src->desc.parallax = src->parallax.items;
+    src->desc.parallaxCount = src->parallax.count;
+}
+
+static void FreeSource(Source *src)
+{
+    free(src->boxes.items);
+    free(src->stars.items);
+    free(src->birds.items);
+    free(src->parallax.items);
+}
+
+static bool ParseFlags(const char *name, uint32_t *flags)
+{
+    if (strcmp(name, "solid") == 0) *flags = COLLISION_SOLID;
+    else if (strcmp(name, "oneway") == 0) *flags = COLLISION_ONE_WAY;
+    else if (strcmp(name, "slopeup") == 0) *flags = COLLISION_SLOPE_UP;
+    else if (strcmp(name, "slopedown") == 0) *flags = COLLISION_SLOPE_DOWN;
+    else return false;
+    return true;
+}
+
+static bool ParseLine(Source *src, const char *line)
+{
+    LevelDesc *d = &src->desc;
+    char kind[16], name[16];
+    if (sscanf(line, "%15s", kind) != 1) return true;
+
+    if (strcmp(kind, "world") == 0)
+        return sscanf(line, "%*s %f %f", &d->worldWidth, &d->groundY) == 2;
+    if (strcmp(kind, "spawn") == 0)
+        return sscanf(line, "%*s %f %f", &d->spawnX, &d->spawnY) == 2;
+    if (strcmp(kind, "lighting") == 0)
+        return sscanf(line, "%*s %f %f %f %f", &d->transitionCenter, &d->transitionWidth,
+                      &d->dayAmbient, &d->nightAmbient) == 4;
+    if (strcmp(kind, "grid") == 0)
+        return sscanf(line, "%*s %f", &d->cellSize) == 1 && d->cellSize > 0.0f;
+
+    if (strcmp(kind, "box") == 0)
+    {
+        CollisionBox b;
+        if (sscanf(line, "%*s %f %f %f %f %15s", &b.x, &b.y, &b.width, &b.height, name) != 5) return false;
+        if (!ParseFlags(name, &b.flags) || b.width <= 0.0f || b.height <= 0.0f) return false;
+        *(CollisionBox *)Push(&src->boxes) = b;
+        return true;
+    }
+    if (strcmp(kind, "star") == 0)
+    {
+        LevelStar s;
+        if (sscanf(line, "%*s %f %f %f %f", &s.x, &s.y, &s.phase, &s.speed) != 4) return false;
+        *(LevelStar *)Push(&src->stars) = s;
+        return true;
+    }
+    if (strcmp(kind, "bird") == 0)
+    {
+        LevelBird b;
+        if (sscanf(line, "%*s %f %f %f %f", &b.x, &b.y, &b.speed, &b.phase) != 4) return false;
+        *(LevelBird *)Push(&src->birds) = b;
+        return true;
+    }
+    if (strcmp(kind, "parallax") == 0)
+    {
+        LevelParallax p;
+        unsigned count, r, g, b, a;
+        if (sscanf(line, "%*s %15s %f %f %f %f %u %u %u %u %u", name, &p.factor, &p.spacing,
+                   &p.y, &p.size, &count, &r, &g, &b, &a) != 10) return false;
+
+        if (strcmp(name, "triangle") == 0) p.shape = LEVEL_PARALLAX_TRIANGLE;
+        else if (strcmp(name, "circle") == 0) p.shape = LEVEL_PARALLAX_CIRCLE;
+        else return false;
+
+        p.count = count;
+        p.color[0] = (uint8_t)r;
+        p.color[1] = (uint8_t)g;
+        p.color[2] = (uint8_t)b;
+        p.color[3] = (uint8_t)a;
+        *(LevelParallax *)Push(&src->parallax) = p;
+        return true;
+    }
+    return false;
+}
+
+static bool ReadSource(Source *src, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    int number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        ok = ParseLine(src, line);
+        if (!ok) fprintf(stderr, "%s:%i: cannot parse: %s\n", path, number, line);
+    }
+    fclose(file);
+
+    FinishSource(src);
+    return ok;
+}
+
+static bool WriteFile(const char *path, const void *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, file) == size;
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+static int Pack(const char *in, const char *out)
+{
+    Source src;
+    InitSource(&src);
+    if (!ReadSource(&src, in))
+    {
+        FreeSource(&src);
+        return 1;
+    }
+
+    const LevelDesc *d = &src.desc;
+    if (!(d->worldWidth > 0.0f && d->worldWidth <= LEVEL_MAX_WORLD_WIDTH) || d->birdCount > LEVEL_MAX_BIRDS)
+    {
+        fprintf(stderr, "levelpack: %s: world width %.0f and %i birds, the format allows up to %.0f and %i\n",
+                in, d->worldWidth, d->birdCount, LEVEL_MAX_WORLD_WIDTH, LEVEL_MAX_BIRDS);
+        FreeSource(&src);
+        return 1;
+    }
+
+    size_t size;
+    void *file = Level_Pack(&src.desc, &size);
+    FreeSource(&src);
+    if (!file)
+    {
+        fprintf(stderr, "levelpack: failed to pack %s\n", in);
+        return 1;
+    }
+
+    // Round-trip through the loader so a bad file never leaves the tool
+    Level level;
+    if (!Level_OpenMemory(&level, file, size, true))
+    {
+        fprintf(stderr, "levelpack: packed %s does not validate\n", in);
+        free(file);
+        return 1;
+    }
+
+    bool ok = Level_VerifyPayload(&level) && WriteFile(out, file, size);
+    if (ok)
+        printf("%s: %i boxes, %u grid cells, %i stars, %i birds, %i parallax layers, %zu bytes\n",
+               out, (int)level.header->boxes.count, level.header->cellStart.count ? level.header->cellStart.count - 1 : 0,
+               level.starCount, level.birdCount, level.parallaxCount, size);
+    Level_Close(&level);
+    return ok ? 0 : 1;
+}
+
+/* =============================
+   LOADER BENCHMARK
+============================= */
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// A ground strip and a staircase of platforms and crates spanning the world
+static void GenerateLevel(Source *src, int boxCount)
+{
+    InitSource(src);
+    LevelDesc *d = &src->desc;
+    d->worldWidth = fminf(boxCount * 60.0f, LEVEL_MAX_WORLD_WIDTH);
+    d->groundY = 520.0f;
+    d->spawnX = 200.0f;
+    d->spawnY = 520.0f;
+    d->transitionCenter = d->worldWidth * 0.5f;
+    d->transitionWidth = 600.0f;
+    d->dayAmbient = 0.40f;
+    d->nightAmbient = 0.75f;
+
+    *(CollisionBox *)Push(&src->boxes) = (CollisionBox){ -200, 544, d->worldWidth + 400, 200, COLLISION_SOLID };
+    for (int i = 1; i < boxCount; i++)
+    {
+        bool crate = (i % 5) == 0;
+        *(CollisionBox *)Push(&src->boxes) = crate
+            ? (CollisionBox){ i * 60.0f, 500, 44, 44, COLLISION_SOLID }
+            : (CollisionBox){ i * 60.0f, 544 - 80.0f - (i % 4) * 60.0f, 100, 12, COLLISION_ONE_WAY };
+    }
+    for (int i = 0; i < 18; i++)
+        *(LevelStar *)Push(&src->stars) = (LevelStar){ 25.0f * i + 20, 60.0f + (i * 37) % 240, i * 0.3f, 1.0f };
+    for (int i = 0; i < 6; i++)
+        *(LevelBird *)Push(&src->birds) = (LevelBird){ -100.0f * i, 100.0f + i * 10, 0.9f, i * 0.7f };
+
+    FinishSource(src);
+}
+
+static int Bench(const char *dir)
+{
+    static const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    const int opens = 2000;
+
+    printf("%10s %12s %14s %14s\n", "boxes", "file bytes", "open+close us", "verify us");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        Source src;
+        GenerateLevel(&src, sizes[s]);
+
+        size_t size;
+        void *file = Level_Pack(&src.desc, &size);
+        FreeSource(&src);
+        if (!file) return 1;
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/bench_%i.%s", dir, sizes[s], LEVEL_EXTENSION);
+        bool written = WriteFile(path, file, size);
+        free(file);
+        if (!written) return 1;
+
+        Level level;
+        double start = Now();
+        for (int i = 0; i < opens; i++)
+        {
+            if (!Level_OpenFile(&level, path)) return 1;
+            Level_Close(&level);
+        }
+        double opened = (Now() - start) / opens;
+
+        // The full checksum walk, which release loads skip
+        Level_OpenFile(&level, path);
+        start = Now();
+        bool ok = Level_VerifyPayload(&level);
+        double verified = Now() - start;
+        Level_Close(&level);
+        remove(path);
+        if (!ok) return 1;
+
+        printf("%10i %12zu %14.2f %14.2f\n", sizes[s], size, opened * 1e6, verified * 1e6);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--bench") == 0) return Bench(argv[2]);
+    if (argc == 3) return Pack(argv[1], argv[2]);
+
+    fprintf(stderr, "usage: levelpack <in.txt> <out.%s>\n       levelpack --bench <dir>\n", LEVEL_EXTENSION);
+    return 2;
+}
@@ -0,0 +1,190 @@
+// Headless rollback check: two peers run the real player simulation against a
+// packed level and exchange inputs over a fake link with latency and jitter.
+// Each peer predicts the other, rolls back on corrections, and records the
+// checksum of every state once it is final. The run fails if the peers'
+// final states ever differ.
+//
+// Build from the repository root:
+//   cc -std=c99 -O2 -ffp-contract=off -Iapp/src/main/cpp -o rollsim tools/rollsim.c
+//      app/src/main/cpp/rollback.c app/src/main/cpp/sim.c
+//      app/src/main/cpp/level.c app/src/main/cpp/collision.c -lm
+//
+// Usage:
+//   rollsim [latency ms] [jitter ms] [ticks] [level.umgl]
+#define _POSIX_C_SOURCE 200809L
+#include "level.h"
+#include "rollback.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TICK_MS        (1000.0 / 60.0)
+#define PEERS          2
+#define MAX_IN_FLIGHT  4096
+
+typedef struct {
+    double deliverAt;
+    uint32_t tick;
+    int player;
+    SimInput input;
+} Packet;
+
+typedef struct {
+    Packet packets[MAX_IN_FLIGHT];
+    int count;
+} Link;
+
+typedef struct {
+    Rollback rb;
+    int player;         // The local one
+    uint32_t sentTick;  // Next local tick to sample and send
+    uint32_t recordTick;
+    uint32_t *checksums; // Final state checksum per tick
+} Peer;
+
+static uint32_t randomState = 0x9E3779B9u;
+
+static uint32_t NextRandom(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+// Scripted play: runs in bursts, changes direction, jumps and double jumps
+static SimInput ScriptedInput(int player, uint32_t tick)
+{
+    uint32_t phase = tick / (40 + 13 * player);
+    uint32_t hash = (phase + 1) * 2654435761u ^ (uint32_t)player * 40503u;
+    SimInput input = { 0, 0 };
+
+    switch (hash % 4)
+    {
+        case 0: input.moveX = 127; break;
+        case 1: input.moveX = -90; break;
+        case 2: input.moveX = 60; break;
+        default: input.moveX = 0; break;
+    }
+    if ((tick + 7 * player) % 47 == 0 || (tick + 7 * player) % 47 == 12) input.buttons = SIM_BUTTON_JUMP;
+    return input;
+}
+
+static void Send(Link *link, double now, double latency, double jitter, uint32_t tick, int player, SimInput input)
+{
+    if (link->count == MAX_IN_FLIGHT)
+    {
+        fprintf(stderr, "rollsim: link overflow\n");
+        exit(1);
+    }
+    double delay = latency + jitter * ((NextRandom() % 2001) / 1000.0 - 1.0);
+    if (delay < 0.0) delay = 0.0;
+    link->packets[link->count++] = (Packet){ now + delay, tick, player, input };
+}
+
+// Delivers everything due, in whatever order the jitter produced
+static void Deliver(Link *link, double now, Rollback *rb)
+{
+    for (int i = 0; i < link->count;)
+    {
+        if (link->packets[i].deliverAt > now)
+        {
+            i++;
+            continue;
+        }
+        Rollback_AddInput(rb, link->packets[i].player, link->packets[i].tick, link->packets[i].input);
+        link->packets[i] = link->packets[--link->count];
+    }
+}
+
+static void RecordFinal(Peer *peer, uint32_t ticks)
+{
+    const Rollback *rb = &peer->rb;
+    uint32_t confirmed = Rollback_ConfirmedTick(rb);
+
+    for (; peer->recordTick <= confirmed && peer->recordTick < ticks; peer->recordTick++)
+    {
+        const SimState *state = (peer->recordTick == rb->current.tick)
+                                ? &rb->current : &rb->states[peer->recordTick % ROLLBACK_RING_SIZE];
+        peer->checksums[peer->recordTick] = Sim_Checksum(state);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double latency = (argc > 1) ? atof(argv[1]) : 80.0;
+    double jitter = (argc > 2) ? atof(argv[2]) : 30.0;
+    uint32_t ticks = (argc > 3) ? (uint32_t)atoi(argv[3]) : 3600;
+    const char *path = (argc > 4) ? argv[4] : "app/src/main/assets/levels/meadow." LEVEL_EXTENSION;
+
+    Level level;
+    if (!Level_OpenFile(&level, path))
+    {
+        fprintf(stderr, "rollsim: cannot open level %s\n", path);
+        return 1;
+    }
+
+    CollisionWorld collision;
+    Level_CollisionWorld(&level, &collision);
+    SimWorld world = { &collision, level.header->worldWidth };
+
+    SimState initial;
+    memset(&initial, 0, sizeof(initial));
+    initial.playerCount = PEERS;
+    for (int p = 0; p < PEERS; p++)
+        Sim_InitPlayer(&initial.players[p], level.header->spawnX + 60.0f * p, level.header->spawnY);
+
+    static Peer peers[PEERS];
+    static Link links[PEERS]; // links[p] carries traffic towards peer p
+    for (int p = 0; p < PEERS; p++)
+    {
+        Rollback_Init(&peers[p].rb, &initial, &world);
+        peers[p].player = p;
+        peers[p].checksums = calloc(ticks, sizeof(uint32_t));
+        if (!peers[p].checksums) return 1;
+    }
+
+    // Keep stepping frames until both peers have finalized every tick
+    double now = 0.0;
+    for (uint32_t frame = 0; peers[0].recordTick < ticks || peers[1].recordTick < ticks; frame++)
+    {
+        now = frame * TICK_MS;
+        for (int p = 0; p < PEERS; p++)
+        {
+            Peer *peer = &peers[p];
+            Deliver(&links[p], now, &peer->rb);
+
+            uint32_t tick = peer->rb.current.tick;
+            if (tick < ticks + ROLLBACK_MAX_PREDICTION && peer->sentTick == tick)
+            {
+                SimInput input = ScriptedInput(peer->player, tick);
+                Rollback_AddInput(&peer->rb, peer->player, tick, input);
+                Send(&links[1 - p], now, latency, jitter, tick, peer->player, input);
+                peer->sentTick++;
+            }
+
+            if (peer->sentTick > peer->rb.current.tick) Rollback_Advance(&peer->rb);
+            RecordFinal(peer, ticks);
+        }
+    }
+
+    uint32_t mismatches = 0;
+    for (uint32_t t = 0; t < ticks; t++)
+        if (peers[0].checksums[t] != peers[1].checksums[t]) mismatches++;
+
+    printf("latency %.0f ms, jitter +-%.0f ms, %u ticks over %.1f s\n", latency, jitter, ticks, now / 1000.0);
+    printf("%-6s %8s %8s %10s %10s %10s %14s %14s\n",
+           "peer", "ticks", "stalls", "rollbacks", "avg depth", "max depth", "resim max us", "us per tick");
+    for (int p = 0; p < PEERS; p++)
+    {
+        const RollbackStats *s = &peers[p].rb.stats;
+        printf("%-6i %8u %8u %10u %10.2f %10i %14u %14.2f\n", p, s->ticks, s->stalls, s->rollbacks,
+               s->rollbacks ? (double)s->resimTicks / s->rollbacks : 0.0, s->maxDepth, s->maxResimMicros,
+               s->resimTicks ? (double)s->totalResimMicros / s->resimTicks : 0.0);
+    }
+    printf("final states compared: %u, mismatches: %u\n", ticks, mismatches);
+
+    for (int p = 0; p < PEERS; p++) free(peers[p].checksums);
+    Level_Close(&level);
+    return mismatches ? 1 : 0;
+}
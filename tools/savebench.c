@@ -0,0 +1,104 @@
+// Cost of the save state the game writes on pause and reads on relaunch:
+// sealing (checksum), validating, and the durable write (temp file, fsync,
+// rename) and read round trip, each through the real savestate.c.
+//
+// Build from the repository root:
+//   cc -std=c99 -O2 -Iapp/src/main/cpp -o savebench tools/savebench.c
+//      app/src/main/cpp/savestate.c
+//
+// Usage:
+//   savebench [dir]   where to write the snapshot, the current directory by default.
+//                     Use the device's storage type: fsync dominates the write.
+#define _POSIX_C_SOURCE 200809L
+#include "savestate.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MEMORY_RUNS 100000
+#define FILE_RUNS   200
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// A full snapshot: every bird slot and both chat buffers in use
+static void Fill(SaveState *state)
+{
+    memset(state, 0, sizeof(SaveState));
+    state->playerX = 1234.5f;
+    state->playerY = 520.0f;
+    state->facingX = 1.0f;
+    state->grounded = 1;
+    state->cameraX = 1042.5f;
+    state->birdCount = SAVESTATE_MAX_BIRDS;
+    for (int i = 0; i < SAVESTATE_MAX_BIRDS; i++)
+    {
+        state->birdX[i] = 100.0f * i;
+        state->birdY[i] = 120.0f + i;
+    }
+    state->chatLength = state->chatSentLength = CHAT_MAX_TEXT - 1;
+    memset(state->chatText, 'a', CHAT_MAX_TEXT - 1);
+    memset(state->chatSentText, 'b', CHAT_MAX_TEXT - 1);
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : ".";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, SAVESTATE_FILE_NAME);
+
+    SaveState state;
+    Fill(&state);
+    printf("snapshot %zu bytes, %s\n\n", sizeof(SaveState), path);
+
+    double start = Now();
+    for (int i = 0; i < MEMORY_RUNS; i++)
+    {
+        state.playerX += 1.0f; // Keep the checksum input changing
+        SaveState_Seal(&state);
+    }
+    double seal = (Now() - start) / MEMORY_RUNS;
+
+    int valid = 0;
+    start = Now();
+    for (int i = 0; i < MEMORY_RUNS; i++) valid += SaveState_Validate(&state, sizeof(state));
+    double validate = (Now() - start) / MEMORY_RUNS;
+
+    double writeTotal = 0.0, writeMax = 0.0, readTotal = 0.0;
+    for (int i = 0; i < FILE_RUNS; i++)
+    {
+        state.playerX += 1.0f;
+        SaveState_Seal(&state);
+
+        start = Now();
+        bool written = SaveState_Write(&state, path);
+        double elapsed = Now() - start;
+        writeTotal += elapsed;
+        if (elapsed > writeMax) writeMax = elapsed;
+
+        SaveState loaded;
+        start = Now();
+        bool read = SaveState_Read(&loaded, path);
+        readTotal += Now() - start;
+
+        if (!written || !read || memcmp(&loaded, &state, sizeof(state)) != 0)
+        {
+            fprintf(stderr, "round trip %i failed\n", i);
+            unlink(path);
+            return 1;
+        }
+    }
+    unlink(path);
+
+    printf("seal      %8.2f us\n", seal * 1e6);
+    printf("validate  %8.2f us (%i/%i valid)\n", validate * 1e6, valid, MEMORY_RUNS);
+    printf("write     %8.2f us average, %.2f us max (temp file, fsync, rename)\n",
+           writeTotal / FILE_RUNS * 1e6, writeMax * 1e6);
+    printf("read      %8.2f us (open, read, validate)\n", readTotal / FILE_RUNS * 1e6);
+    return valid == MEMORY_RUNS ? 0 : 1;
+}